@@ -0,0 +1,143 @@
+//*****************************************************************************
+// Edge language output allocation check
+// written by Josh Hawkins
+//*****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "parser.h"
+#include "generate.h"
+
+using namespace std;
+
+// Size of the graph written
+#define ALLOC_CHECK_VERTICES 50000
+#define ALLOC_CHECK_EDGES    200000
+#define ALLOC_CHECK_RING     1000
+
+// Formats checked
+static const char *checkedFormats[] = { "js", "dot", "graphml", "json" };
+#define CHECKED_FORMAT_COUNT (sizeof(checkedFormats) / sizeof(checkedFormats[0]))
+
+// Allocations counted while counting is on. Every allocation of the
+// program goes through here, so counting off costs one relaxed load. The
+// replacement is kept in the release binary on purpose: the check has to
+// measure the emitters as they are shipped, with the same build flags, and
+// a malloc call behind one well-predicted branch is not measurable next to
+// the allocation itself.
+static atomic<bool>   counting(false);
+static atomic<size_t> allocations(0);
+
+//*****************************************************************************
+void *operator new(size_t size)
+{
+  if (counting.load(memory_order_relaxed))
+    allocations.fetch_add(1, memory_order_relaxed);
+
+  void *p = malloc(size ? size : 1);
+  if (p == NULL)
+    throw bad_alloc();
+  return p;
+}
+//*****************************************************************************
+void operator delete(void *p) noexcept
+{
+  free(p);
+}
+//*****************************************************************************
+void operator delete(void *p, size_t) noexcept
+{
+  free(p);
+}
+//*****************************************************************************
+// Vertex names of letters, labels that need quoting and escaping, a mix of
+// directed and undirected edges, and a generated structure
+static void buildGraph(Graph &graph)
+{
+  string name, label;
+
+  graph = Graph();
+  for (size_t i = 0; i < ALLOC_CHECK_VERTICES; i++) {
+    name.clear();
+    for (size_t n = i; ; n = n / 26 - 1) {
+      name.insert(name.begin(), (char) ('A' + n % 26));
+      if (n < 26)
+        break;
+    }
+    label = "it's <" + to_string(i) + "> \"\\\"";
+    assignLabel(graph, addVertex(graph, name, "_"), label, "_");
+  }
+
+  for (size_t i = 0; i < ALLOC_CHECK_EDGES; i++)
+    addEdge(graph, i % ALLOC_CHECK_VERTICES, i * 7919 % ALLOC_CHECK_VERTICES,
+            i % 3 == 0);
+
+  // A ring the js format writes as a loop, linked to from outside
+  GeneratorCall ring;
+  ring.name = "ring";
+  ring.numbers[0] = ALLOC_CHECK_RING;
+  ring.count = 1;
+  ring.prefix = "R";
+  generateStructure(graph, ring, false, "_");
+  addEdge(graph, 0, ALLOC_CHECK_VERTICES, true);
+
+  PropertyValue title = graph.properties.values[PROP_TITLE];
+  title.text = "allocation check";
+  changeProperty(graph, PROP_TITLE, title);
+}
+//*****************************************************************************
+// Each format writes the graph once so its buffers reach full size, then
+// again while allocations are counted. The second write must not allocate
+// at all.
+int allocationCheck()
+{
+  Graph graph;
+  bool passed = true;
+
+  buildGraph(graph);
+  cout << "=== Edge output allocation check ===" << endl << endl
+       << graph.vertices.size() << " vertices, " << graph.edges.size()
+       << " edges" << endl;
+
+  for (size_t f = 0; f < CHECKED_FORMAT_COUNT; f++) {
+    Emitter *emitter = makeEmitter(checkedFormats[f]);
+    OutputFile out;
+    if (!out.open("/dev/null")) {
+      cout << "***ERROR: cannot write /dev/null" << endl;
+      delete emitter;
+      return 1;
+    }
+
+    try {
+      emitter->emit(graph, out);
+
+      allocations.store(0);
+      counting.store(true);
+      emitter->emit(graph, out);
+      counting.store(false);
+
+      out.close();
+    } catch (char const *errmsg) {
+      counting.store(false);
+      cout << "***ERROR: " << errmsg << endl;
+      delete emitter;
+      return 1;
+    }
+    delete emitter;
+
+    size_t counted = allocations.load();
+    passed = passed && counted == 0;
+    printf("%-8s %lu allocations %s\n", checkedFormats[f],
+           (unsigned long) counted, counted == 0 ? "ok" : "TOO MANY");
+  }
+
+  if (!passed) {
+    cout << endl << "***ERROR: writing the graph allocates" << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,203 @@
+//*****************************************************************************
+// Edge language batch conversion
+// written by Josh Hawkins
+//*****************************************************************************
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "parser.h"
+#include "scheduler.h"
+#include "trace.h"
+
+using namespace std;
+
+// Vertices or edges formatted by one task
+#define BATCH_CHUNK_RECORDS (1 << 16)
+
+// A program file being converted
+struct BatchFile {
+  string         input;
+  string         output;
+  Graph          graph;
+  vector<string> parts;       // the output, in order
+  atomic<size_t> unformatted; // parts still to be formatted
+  string         error;       // why the file could not be converted
+};
+
+// Everything the tasks of a batch share
+struct Batch {
+  Scheduler          *scheduler;
+  vector<Emitter *>   emitters;   // one per worker
+  vector<BatchFile *> files;
+};
+
+static void parseTask ( Batch *, size_t );
+
+//*****************************************************************************
+// The output file for a program: its name with the format as extension
+static string outputPath(const string &input, const string &format)
+{
+  size_t slash = input.rfind('/');
+  size_t dot = input.rfind('.');
+  if (dot == string::npos || (slash != string::npos && dot < slash))
+    dot = input.size();
+  return input.substr(0, dot) + "." + format;
+}
+//*****************************************************************************
+static void writeTask(BatchFile *file)
+{
+  if (tracing)
+    traceBegin("write", "emit");
+  OutputFile out;
+  if (!out.open(file->output))
+    file->error = "cannot write '" + file->output + "'";
+  else {
+    try {
+      out.write(file->parts);
+      out.close();
+    } catch (char const *errmsg) {
+      file->error = errmsg;
+    }
+  }
+  if (tracing)
+    traceEnd("write", "emit");
+
+  vector<string>().swap(file->parts);
+  file->graph = Graph();
+}
+//*****************************************************************************
+// Whichever chunk is formatted last queues the write
+static void formatTask(Batch *batch, BatchFile *file, size_t part,
+                       bool vertices, size_t first, size_t last)
+{
+  Emitter *emitter = batch->emitters[Scheduler::current()];
+  const char *name = vertices ? "format vertices" : "format edges";
+  if (tracing)
+    traceBegin(name, "emit");
+  if (vertices)
+    emitter->formatVertices(file->graph, first, last, file->parts[part]);
+  else
+    emitter->formatEdges(file->graph, first, last, file->parts[part]);
+  if (tracing)
+    traceEnd(name, "emit");
+
+  if (file->unformatted.fetch_sub(1) == 1)
+    batch->scheduler->spawn(bind(writeTask, file));
+}
+//*****************************************************************************
+// Split the output into the header, chunks of vertices, the edge header,
+// chunks of edges and the footer. The chunks become tasks of their own.
+static void formatFile(Batch *batch, BatchFile *file)
+{
+  Emitter *emitter = batch->emitters[Scheduler::current()];
+  const Graph &graph = file->graph;
+  size_t vertexChunks = (graph.vertices.size() + BATCH_CHUNK_RECORDS - 1)
+                        / BATCH_CHUNK_RECORDS;
+  size_t edgeChunks = (graph.edges.size() + BATCH_CHUNK_RECORDS - 1)
+                      / BATCH_CHUNK_RECORDS;
+
+  // Output that needs the whole graph is formatted in one piece
+  if (!emitter->formatsEdgesAlone(graph)) {
+    file->parts.resize(1);
+    emitter->format(graph, file->parts[0]);
+    file->unformatted.store(0);
+    batch->scheduler->spawn(bind(writeTask, file));
+    return;
+  }
+
+  file->parts.resize(vertexChunks + edgeChunks + 3);
+  emitter->formatHeader(graph, file->parts[0]);
+  emitter->formatEdgeHeader(graph, file->parts[vertexChunks + 1]);
+  emitter->formatFooter(graph, file->parts.back());
+
+  file->unformatted.store(vertexChunks + edgeChunks);
+  if (vertexChunks + edgeChunks == 0) {
+    batch->scheduler->spawn(bind(writeTask, file));
+    return;
+  }
+
+  for (size_t c = 0; c < vertexChunks; c++) {
+    size_t first = c * BATCH_CHUNK_RECORDS;
+    size_t last = min(first + BATCH_CHUNK_RECORDS, graph.vertices.size());
+    batch->scheduler->spawn(bind(formatTask, batch, file, 1 + c, true,
+                                 first, last));
+  }
+  for (size_t c = 0; c < edgeChunks; c++) {
+    size_t first = c * BATCH_CHUNK_RECORDS;
+    size_t last = min(first + BATCH_CHUNK_RECORDS, graph.edges.size());
+    batch->scheduler->spawn(bind(formatTask, batch, file,
+                                 vertexChunks + 2 + c, false, first, last));
+  }
+}
+//*****************************************************************************
+// The scanner and parser keep their state in globals, so files are parsed
+// one at a time: each parse queues the next once it is done, after the
+// formatting of its own file, and its own worker takes the newest task
+// first. Other workers meanwhile steal the formatting and writing.
+static void parseTask(Batch *batch, size_t k)
+{
+  BatchFile *file = batch->files[k];
+
+  try {
+    parseFile(file->input);
+    swap(file->graph, graph);
+    resetParser();
+    formatFile(batch, file);
+  } catch (char const *errmsg) {
+    char line[32];
+    snprintf(line, sizeof(line), "%d", parseLine);
+    file->error = string("***ERROR (line ") + line + "): " + errmsg;
+  }
+
+  if (k + 1 < batch->files.size())
+    batch->scheduler->spawn(bind(parseTask, batch, k + 1));
+}
+//*****************************************************************************
+int runBatch(const vector<string> &inputs, const string &format, int threads)
+{
+  if (threads <= 0)
+    threads = thread::hardware_concurrency();
+
+  Batch batch;
+  batch.scheduler = new Scheduler(threads);
+  for (size_t i = 0; i < batch.scheduler->size(); i++)
+    batch.emitters.push_back(makeEmitter(format));
+  for (size_t i = 0; i < inputs.size(); i++) {
+    batch.files.push_back(new BatchFile());
+    batch.files[i]->input = inputs[i];
+    batch.files[i]->output = outputPath(inputs[i], format);
+  }
+
+  if (!batch.files.empty())
+    batch.scheduler->spawn(bind(parseTask, &batch, 0));
+  batch.scheduler->wait();
+
+  // Report failures in the order the files were given
+  int failed = 0;
+  for (size_t i = 0; i < batch.files.size(); i++) {
+    if (!batch.files[i]->error.empty()) {
+      cout << batch.files[i]->input << ": " << batch.files[i]->error << endl;
+      failed++;
+    }
+    delete batch.files[i];
+  }
+
+  vector<WorkerStats> stats = batch.scheduler->stats();
+  double elapsed = batch.scheduler->elapsed();
+  printf("=== Edge batch: %lu files, %d failed, %.3f s ===\n",
+         (unsigned long) inputs.size(), failed, elapsed);
+  printf("Worker   Tasks  Stolen    Busy\n");
+  for (size_t i = 0; i < stats.size(); i++)
+    printf("%6lu  %6lu  %6lu  %5.1f%%\n", (unsigned long) i,
+           (unsigned long) stats[i].tasks, (unsigned long) stats[i].stolen,
+           elapsed > 0 ? 100 * stats[i].busy / elapsed : 0.0);
+
+  delete batch.scheduler;
+  for (size_t i = 0; i < batch.emitters.size(); i++)
+    delete batch.emitters[i];
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,221 @@
+//*****************************************************************************
+// Edge language semantic checks
+// written by Josh Hawkins
+//*****************************************************************************
+#include <algorithm>
+#include <unordered_map>
+
+#include "check.h"
+
+using namespace std;
+
+// Most vertices of a cycle spelled out in a finding
+#define CYCLE_NAMES_SHOWN 8
+
+// Walk marks used while looking for cycles
+#define UNSEEN  0
+#define WALKING 1
+#define DONE    2
+
+//*****************************************************************************
+// Recording
+//*****************************************************************************
+void logEdges(CheckLog &log, const Graph &graph, int line)
+{
+  log.edgeLines.resize(graph.edges.size(), line);
+}
+//*****************************************************************************
+void logBinding(CheckLog &log, const Graph &graph, int position, int line,
+                bool bound)
+{
+  if (log.activeBinding.size() < graph.vertices.size())
+    log.activeBinding.resize(graph.vertices.size(), -1);
+
+  // Assigning the default label leaves the vertex without a binding
+  if (!bound) {
+    log.activeBinding[position] = -1;
+    return;
+  }
+
+  Binding binding;
+  binding.position = position;
+  binding.label = graph.vertices[position].label;
+  binding.line = line;
+  binding.used = false;
+
+  log.activeBinding[position] = log.bindings.size();
+  log.bindings.push_back(binding);
+}
+//*****************************************************************************
+void logUse(CheckLog &log, int position)
+{
+  if ((size_t) position < log.activeBinding.size() &&
+      log.activeBinding[position] >= 0)
+    log.bindings[log.activeBinding[position]].used = true;
+}
+//*****************************************************************************
+void logFinding(CheckLog &log, int line, const string &message)
+{
+  Finding finding;
+  finding.line = line;
+  finding.message = message;
+  log.findings.push_back(finding);
+}
+
+//*****************************************************************************
+// Checks
+//*****************************************************************************
+static int edgeLine(const CheckLog &log, size_t edge)
+{
+  return edge < log.edgeLines.size() ? log.edgeLines[edge] : 0;
+}
+//*****************************************************************************
+static void checkLabels(CheckLog &log, const Graph &graph)
+{
+  for (size_t i = 0; i < log.bindings.size(); i++) {
+    const Binding &binding = log.bindings[i];
+    if (!binding.used)
+      logFinding(log, binding.line, string("label '") + &graph.text[binding.label] +
+                 "' is bound to " + vertexName(graph, binding.position) +
+                 " but never used");
+  }
+}
+//*****************************************************************************
+// Self-loops, and edges repeating an earlier edge. Undirected edges are
+// the same whichever way round they are written.
+static void checkEdges(CheckLog &log, const Graph &graph)
+{
+  unordered_map<uint64_t, int> seen;
+  seen.reserve(graph.edges.size());
+
+  for (size_t i = 0; i < graph.edges.size(); i++) {
+    const Edge &edge = graph.edges[i];
+    const char *arrow = edge.directed ? " -> " : " -- ";
+    int line = edgeLine(log, i);
+
+    if (edge.source == edge.target)
+      logFinding(log, line, string("self-loop on ") + vertexName(graph, edge.source));
+
+    uint64_t source = edge.source, target = edge.target;
+    if (!edge.directed && source > target)
+      swap(source, target);
+    uint64_t key = source << 33 | target << 1 | edge.directed;
+
+    pair<unordered_map<uint64_t, int>::iterator, bool> added =
+      seen.insert(make_pair(key, line));
+    if (!added.second)
+      logFinding(log, line, string("duplicate edge ") +
+                 vertexName(graph, edge.source) + arrow +
+                 vertexName(graph, edge.target) + ", first on line " +
+                 to_string(added.first->second));
+  }
+}
+//*****************************************************************************
+// Kahn's algorithm over the directed edges, leaving out self-loops, which
+// are reported on their own. Vertices it cannot order lie on or behind a
+// cycle; walking back along their incoming edges finds one cycle for each
+// tangle of them. Everything is iterative, so deep graphs cannot overflow
+// the stack.
+static void checkCycles(CheckLog &log, const Graph &graph)
+{
+  size_t n = graph.vertices.size();
+  vector<int> indegree(n, 0);
+  vector<size_t> outStart(n + 1, 0), inStart(n + 1, 0);
+
+  for (size_t i = 0; i < graph.edges.size(); i++) {
+    const Edge &edge = graph.edges[i];
+    if (edge.directed && edge.source != edge.target) {
+      outStart[edge.source + 1]++;
+      inStart[edge.target + 1]++;
+      indegree[edge.target]++;
+    }
+  }
+  for (size_t v = 0; v < n; v++) {
+    outStart[v + 1] += outStart[v];
+    inStart[v + 1] += inStart[v];
+  }
+
+  // Edge positions grouped by source and by target
+  vector<uint32_t> outEdges(outStart[n]), inEdges(inStart[n]);
+  vector<size_t> outFill(outStart.begin(), outStart.end() - 1);
+  vector<size_t> inFill(inStart.begin(), inStart.end() - 1);
+  for (size_t i = 0; i < graph.edges.size(); i++) {
+    const Edge &edge = graph.edges[i];
+    if (edge.directed && edge.source != edge.target) {
+      outEdges[outFill[edge.source]++] = i;
+      inEdges[inFill[edge.target]++] = i;
+    }
+  }
+
+  // Topological sort
+  vector<uint32_t> ready;
+  for (size_t v = 0; v < n; v++)
+    if (indegree[v] == 0)
+      ready.push_back(v);
+  while (!ready.empty()) {
+    uint32_t v = ready.back();
+    ready.pop_back();
+    for (size_t j = outStart[v]; j < outStart[v + 1]; j++)
+      if (--indegree[graph.edges[outEdges[j]].target] == 0)
+        ready.push_back(graph.edges[outEdges[j]].target);
+  }
+
+  // Every vertex left has an incoming edge from another one left
+  vector<char> mark(n, UNSEEN);
+  vector<uint32_t> walk, path;
+
+  for (size_t start = 0; start < n; start++) {
+    if (indegree[start] == 0 || mark[start] != UNSEEN)
+      continue;
+
+    walk.clear();
+    path.clear();
+    uint32_t v = start;
+    while (mark[v] == UNSEEN) {
+      mark[v] = WALKING;
+      walk.push_back(v);
+      for (size_t j = inStart[v]; j < inStart[v + 1]; j++) {
+        if (indegree[graph.edges[inEdges[j]].source] > 0) {
+          path.push_back(inEdges[j]);
+          break;
+        }
+      }
+      v = graph.edges[path.back()].source;
+    }
+
+    if (mark[v] == WALKING) {
+      // The cycle is the end of the walk from v, read backwards
+      size_t first = find(walk.begin(), walk.end(), v) - walk.begin();
+      string message = string("cycle ") + vertexName(graph, v);
+      int line = 0;
+
+      for (size_t k = path.size(); k-- > first; ) {
+        const Edge &edge = graph.edges[path[k]];
+        line = max(line, edgeLine(log, path[k]));
+        if (path.size() - k <= CYCLE_NAMES_SHOWN)
+          message += string(" -> ") + vertexName(graph, edge.target);
+        else if (k == first)
+          message += string(" -> ... -> ") + vertexName(graph, edge.target);
+      }
+      logFinding(log, line, message);
+    }
+
+    for (size_t k = 0; k < walk.size(); k++)
+      mark[walk[k]] = DONE;
+  }
+}
+//*****************************************************************************
+static bool findingLess(const Finding &a, const Finding &b)
+{
+  return a.line < b.line;
+}
+//*****************************************************************************
+void checkGraph(CheckLog &log, const Graph &graph)
+{
+  checkLabels(log, graph);
+  checkEdges(log, graph);
+  if (graph.directedEdges > 0)
+    checkCycles(log, graph);
+
+  stable_sort(log.findings.begin(), log.findings.end(), findingLess);
+}
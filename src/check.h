@@ -0,0 +1,54 @@
+//*****************************************************************************
+// Edge language semantic checks
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "graph.h"
+
+// Something wrong with a program, found by --check
+struct Finding {
+  int         line;
+  std::string message;
+};
+
+// A label bound to a vertex by an assignment
+struct Binding {
+  int      position;    // the vertex
+  uint32_t label;       // offset of the label in Graph::text
+  int      line;        // line of the assignment
+  bool     used;        // referred to by an edge while bound
+};
+
+// What the checks need to know beyond the graph itself, recorded while the
+// program is parsed
+struct CheckLog {
+  std::vector<int>     edgeLines;       // line of each edge, by position
+  std::vector<Binding> bindings;        // every binding, in source order
+  std::vector<int>     activeBinding;   // binding of each vertex, or -1
+  std::vector<Finding> findings;
+};
+
+// Record the line of every edge added since the last call
+void logEdges ( CheckLog &, const Graph &, int );
+
+// Record the label just assigned to a vertex, which may be the default
+void logBinding ( CheckLog &, const Graph &, int, int, bool );
+
+// Record that an edge referred to a vertex by its label
+void logUse ( CheckLog &, int );
+
+// Record a problem found while parsing
+void logFinding ( CheckLog &, int, const std::string & );
+
+// Check the parsed graph for unused labels, self-loops, duplicate edges and
+// directed cycles, then sort every finding by line
+void checkGraph ( CheckLog &, const Graph & );
+
+#endif
@@ -0,0 +1,651 @@
+//*****************************************************************************
+// Edge language output emitters
+// written by Josh Hawkins
+//*****************************************************************************
+#include <charconv>
+
+#include "emit.h"
+#include "trace.h"
+
+using namespace std;
+
+//*****************************************************************************
+// Emitter base class
+//*****************************************************************************
+Emitter::Emitter() : part(false), out(NULL)
+{
+  buffer.reserve(EMIT_FLUSH_SIZE + 4096);
+}
+//*****************************************************************************
+void Emitter::emit(const Graph &graph, OutputFile &file)
+{
+  out = &file;
+  buffer.clear();
+  write(graph);
+  flush();
+  out = NULL;
+}
+//*****************************************************************************
+void Emitter::format(const Graph &graph, string &text)
+{
+  buffer.swap(text);
+  write(graph);
+  buffer.swap(text);
+}
+//*****************************************************************************
+void Emitter::write(const Graph &graph)
+{
+  begin(graph);
+  header(graph);
+  for (size_t i = 0; i < graph.vertices.size(); i++) {
+    vertex(graph, i);
+    if (out && buffer.size() >= EMIT_FLUSH_SIZE)
+      flush();
+  }
+
+  edges(graph);
+  for (size_t i = 0; i < graph.edges.size(); i++) {
+    edge(graph, graph.edges[i], i);
+    if (out && buffer.size() >= EMIT_FLUSH_SIZE)
+      flush();
+  }
+
+  footer(graph);
+  end();
+}
+//*****************************************************************************
+// Edges formatted early are thrown away if the backend would write some of
+// them differently with the whole graph in hand
+void Emitter::emit(const Graph &graph, OutputFile &file, const string &edgeText)
+{
+  if (!formatsEdgesAlone(graph)) {
+    emit(graph, file);
+    return;
+  }
+
+  out = &file;
+  buffer.clear();
+
+  header(graph);
+  for (size_t i = 0; i < graph.vertices.size(); i++) {
+    vertex(graph, i);
+    if (buffer.size() >= EMIT_FLUSH_SIZE)
+      flush();
+  }
+
+  edges(graph);
+  flush();
+  out->write(edgeText);
+
+  footer(graph);
+  flush();
+  out = NULL;
+}
+//*****************************************************************************
+// The records go to the caller's string instead of the buffer, so this can
+// run on another emitter while the graph is still growing
+void Emitter::formatEdges(const Graph &graph, size_t first, size_t last,
+                          string &text)
+{
+  buffer.swap(text);
+  for (size_t i = first; i < last; i++)
+    edge(graph, graph.edges[i], i);
+  buffer.swap(text);
+}
+//*****************************************************************************
+void Emitter::formatHeader(const Graph &graph, string &text)
+{
+  buffer.swap(text);
+  header(graph);
+  buffer.swap(text);
+}
+//*****************************************************************************
+void Emitter::formatVertices(const Graph &graph, size_t first, size_t last,
+                             string &text)
+{
+  buffer.swap(text);
+  for (size_t i = first; i < last; i++)
+    vertex(graph, i);
+  buffer.swap(text);
+}
+//*****************************************************************************
+void Emitter::formatEdgeHeader(const Graph &graph, string &text)
+{
+  buffer.swap(text);
+  edges(graph);
+  buffer.swap(text);
+}
+//*****************************************************************************
+void Emitter::formatFooter(const Graph &graph, string &text)
+{
+  buffer.swap(text);
+  footer(graph);
+  buffer.swap(text);
+}
+//*****************************************************************************
+void Emitter::flush()
+{
+  if (tracing)
+    traceBegin("flush", "emit");
+  out->write(buffer.data(), buffer.size());
+  if (tracing)
+    traceEnd("flush", "emit");
+  buffer.clear();
+}
+//*****************************************************************************
+// Characters needing no escape are appended a run at a time
+void Emitter::quoted(const char *text, char quote)
+{
+  buffer += quote;
+  for (const char *run = text; ; text++) {
+    if (*text != quote && *text != '\\' && *text != '\0')
+      continue;
+
+    buffer.append(run, text - run);
+    if (*text == '\0')
+      break;
+    buffer += '\\';
+    buffer += *text;
+    run = text + 1;
+  }
+  buffer += quote;
+}
+//*****************************************************************************
+void Emitter::number(size_t n)
+{
+  char digits[24];
+  char *end = to_chars(digits, digits + sizeof(digits), n).ptr;
+  buffer.append(digits, end - digits);
+}
+
+//*****************************************************************************
+// NodeView JavaScript, loaded by test/index.html
+//
+// When the whole graph is written at once, each structure a generator built
+// is written as loops that create its nodes into an array and link them in
+// the order its edges were added. A structure is first checked against the
+// edges actually there; any that does not match is written edge by edge.
+//*****************************************************************************
+
+// Call f(a, b) for each edge of a structure, in the order its generator
+// adds them, a and b counting from its first vertex
+template <class F>
+static void structureEdges(const Structure &s, F f)
+{
+  switch (s.kind) {
+    case STRUCTURE_CHAIN:
+    case STRUCTURE_RING:
+      for (uint32_t i = 1; i < s.vertices; i++)
+        f(i - 1, i);
+      if (s.kind == STRUCTURE_RING)
+        f(s.vertices - 1, 0);
+      break;
+
+    case STRUCTURE_GRID:
+      for (uint32_t i = 0; i < s.vertices; i++) {
+        if (i % s.width > 0)
+          f(i - 1, i);
+        if (i >= s.width)
+          f(i - s.width, i);
+      }
+      break;
+
+    case STRUCTURE_COMPLETE:
+      for (uint32_t i = 0; i < s.vertices; i++)
+        for (uint32_t j = i + 1; j < s.vertices; j++)
+          f(i, j);
+      break;
+  }
+}
+
+class JsEmitter : public Emitter
+{
+public:
+  JsEmitter() : vertexLoop(0), edgeLoop(0) {}
+
+  // Structures may be written as loops, which begin works out
+  bool formatsEdgesAlone(const Graph &graph) const
+  {
+    return graph.structures.empty();
+  }
+
+protected:
+  void begin(const Graph &graph)
+  {
+    loops.clear();
+    vertexLoop = edgeLoop = 0;
+
+    uint64_t vertexEnd = 0, edgeEnd = 0;
+    for (size_t k = 0; k < graph.structures.size(); k++) {
+      const Structure &s = graph.structures[k];
+      if (s.firstVertex >= vertexEnd && s.firstEdge >= edgeEnd &&
+          matches(graph, s)) {
+        loops.push_back(&s);
+        vertexEnd = (uint64_t) s.firstVertex + s.vertices;
+        edgeEnd = (uint64_t) s.firstEdge + s.edges;
+      }
+    }
+    if (loops.empty())
+      return;
+
+    // Vertices of a loop that other edges link are also given their names
+    named.assign(graph.vertices.size(), false);
+    size_t e = 0;
+    for (size_t k = 0; k <= loops.size(); k++) {
+      size_t stop = k < loops.size() ? loops[k]->firstEdge : graph.edges.size();
+      for (; e < stop; e++) {
+        named[graph.edges[e].source] = true;
+        named[graph.edges[e].target] = true;
+      }
+      if (k < loops.size())
+        e = loops[k]->firstEdge + loops[k]->edges;
+    }
+  }
+
+  void end()
+  {
+    loops.clear();
+  }
+
+  // A part adds its nodes to the graph created by the output before it
+  void header(const Graph &)
+  {
+    if (part) {
+      fragment("/* Generated by Edge v.0.0.1 */\n"
+               "(function(graph) {"
+               "\n  /* Create nodes */");
+      return;
+    }
+    fragment("/* Generated by Edge v.0.0.1 */\n"
+             "(function() {"
+             "\n  var graph = new Graph2D(document.getElementById('edgecanvas'));"
+             "\n  graph.setOption('applyGravity', false);"
+             "\n\n  /* Create nodes */");
+  }
+
+  void vertex(const Graph &graph, size_t i)
+  {
+    if (vertexLoop < loops.size() && i >= loops[vertexLoop]->firstVertex) {
+      loopVertex(graph, i);
+      return;
+    }
+
+    fragment("\n  var ");
+    text(vertexName(graph, i));
+    fragment(" = graph.createNode({renderData: {name: ");
+    quoted(vertexLabel(graph, i), '\'');
+    fragment("}});");
+  }
+
+  void edges(const Graph &)
+  {
+    fragment("\n\n  /* Create edges */");
+  }
+
+  void edge(const Graph &graph, const Edge &e, size_t i)
+  {
+    // Structures without edges have nothing to write here
+    while (edgeLoop < loops.size() &&
+           i >= (size_t) loops[edgeLoop]->firstEdge + loops[edgeLoop]->edges)
+      edgeLoop++;
+    if (edgeLoop < loops.size() && i >= loops[edgeLoop]->firstEdge) {
+      if (i == loops[edgeLoop]->firstEdge)
+        loopEdges();
+      return;
+    }
+
+    const char *target = vertexName(graph, e.target);
+
+    fragment("\n  graph.linkNodes(");
+    text(vertexName(graph, e.source));
+    fragment(", ");
+    text(target);
+    if (e.directed) {
+      fragment(", { $directedTowards: ");
+      text(target);
+      fragment(" }");
+    }
+    fragment(");");
+  }
+
+  void footer(const Graph &)
+  {
+    if (part)
+      fragment("\n})(window.edgeGraph);");
+    else
+      fragment("\n})();");
+  }
+
+private:
+  // Whether a structure's vertices and edges are still the ones its shape
+  // gives, all with one label
+  bool matches(const Graph &graph, const Structure &s)
+  {
+    if (s.vertices == 0 ||
+        (uint64_t) s.firstVertex + s.vertices > graph.vertices.size() ||
+        (uint64_t) s.firstEdge + s.edges > graph.edges.size() ||
+        (s.kind == STRUCTURE_GRID && (s.width == 0 || s.vertices % s.width)))
+      return false;
+
+    uint32_t label = graph.vertices[s.firstVertex].label;
+    for (uint32_t i = 1; i < s.vertices; i++)
+      if (graph.vertices[s.firstVertex + i].label != label)
+        return false;
+
+    bool same = true;
+    size_t e = s.firstEdge, stop = (size_t) s.firstEdge + s.edges;
+    structureEdges(s, [&](uint32_t a, uint32_t b) {
+      same = same && e < stop && graph.edges[e].source == s.firstVertex + a &&
+             graph.edges[e].target == s.firstVertex + b &&
+             graph.edges[e].directed == s.directed;
+      e++;
+    });
+    return same && e == stop;
+  }
+
+  // The nodes of a loop are created together at its first vertex; vertices
+  // linked from outside it then take their names from the array
+  void loopVertex(const Graph &graph, size_t i)
+  {
+    const Structure &s = *loops[vertexLoop];
+    if (i == s.firstVertex) {
+      fragment("\n  var s");
+      number(vertexLoop);
+      fragment(" = [];\n  for (var i = 0; i < ");
+      number(s.vertices);
+      fragment("; i++)\n    s");
+      number(vertexLoop);
+      fragment(".push(graph.createNode({renderData: {name: ");
+      quoted(vertexLabel(graph, i), '\'');
+      fragment("}}));");
+    }
+
+    if (named[i]) {
+      fragment("\n  var ");
+      text(vertexName(graph, i));
+      fragment(" = s");
+      number(vertexLoop);
+      buffer += '[';
+      number(i - s.firstVertex);
+      fragment("];");
+    }
+
+    if (i == (size_t) s.firstVertex + s.vertices - 1)
+      vertexLoop++;
+  }
+
+  // Link two nodes of the current loop, given as JavaScript expressions
+  template <size_t N, size_t M>
+  void loopLink(const char (&from)[N], const char (&to)[M])
+  {
+    const Structure &s = *loops[edgeLoop];
+    fragment("graph.linkNodes(s");
+    number(edgeLoop);
+    buffer += '[';
+    fragment(from);
+    fragment("], s");
+    number(edgeLoop);
+    buffer += '[';
+    fragment(to);
+    buffer += ']';
+    if (s.directed) {
+      fragment(", { $directedTowards: s");
+      number(edgeLoop);
+      buffer += '[';
+      fragment(to);
+      fragment("] }");
+    }
+    fragment(");");
+  }
+
+  void loopEdges()
+  {
+    const Structure &s = *loops[edgeLoop];
+    switch (s.kind) {
+      case STRUCTURE_CHAIN:
+        fragment("\n  for (var i = 1; i < ");
+        number(s.vertices);
+        fragment("; i++)\n    ");
+        loopLink("i - 1", "i");
+        break;
+
+      // The last link closes the ring
+      case STRUCTURE_RING:
+        fragment("\n  for (var i = 1, n = ");
+        number(s.vertices);
+        fragment("; i <= n; i++)\n    ");
+        loopLink("i - 1", "i % n");
+        break;
+
+      case STRUCTURE_GRID:
+        fragment("\n  for (var i = 0, w = ");
+        number(s.width);
+        fragment("; i < ");
+        number(s.vertices);
+        fragment("; i++) {\n    if (i % w > 0)\n      ");
+        loopLink("i - 1", "i");
+        fragment("\n    if (i >= w)\n      ");
+        loopLink("i - w", "i");
+        fragment("\n  }");
+        break;
+
+      case STRUCTURE_COMPLETE:
+        fragment("\n  for (var i = 0; i < ");
+        number(s.vertices);
+        fragment("; i++)\n    for (var j = i + 1; j < ");
+        number(s.vertices);
+        fragment("; j++)\n      ");
+        loopLink("i", "j");
+        break;
+    }
+  }
+
+  std::vector<const Structure *> loops;   // structures written as loops
+  std::vector<bool>              named;   // vertices linked from outside them
+  size_t vertexLoop;                      // loop the next vertex may be in
+  size_t edgeLoop;                        // loop the next edge may be in
+};
+
+//*****************************************************************************
+// Graphviz DOT
+//*****************************************************************************
+class DotEmitter : public Emitter
+{
+public:
+  // Edge operators depend on whether any edge in the graph is directed
+  bool formatsEdgesEarly() const { return false; }
+
+protected:
+  void header(const Graph &graph)
+  {
+    // DOT cannot mix edge operators, so any directed edge makes a digraph
+    fragment("/* Generated by Edge v.0.0.1 */\n");
+    if (graph.directedEdges)
+      fragment("digraph edge {");
+    else
+      fragment("graph edge {");
+
+    const string &title = graph.properties.text(PROP_TITLE);
+    if (!title.empty()) {
+      fragment("\n  label=");
+      quoted(title.c_str(), '"');
+      buffer += ';';
+    }
+  }
+
+  void vertex(const Graph &graph, size_t i)
+  {
+    fragment("\n  ");
+    quoted(vertexName(graph, i), '"');
+    fragment(" [label=");
+    quoted(vertexLabel(graph, i), '"');
+    fragment("];");
+  }
+
+  void edge(const Graph &graph, const Edge &e, size_t)
+  {
+    fragment("\n  ");
+    quoted(vertexName(graph, e.source), '"');
+    if (graph.directedEdges)
+      fragment(" -> ");
+    else
+      fragment(" -- ");
+    quoted(vertexName(graph, e.target), '"');
+    if (graph.directedEdges && !e.directed)
+      fragment(" [dir=none]");
+    buffer += ';';
+  }
+
+  void footer(const Graph &)
+  {
+    fragment("\n}\n");
+  }
+};
+
+//*****************************************************************************
+// GraphML
+//*****************************************************************************
+class GraphMLEmitter : public Emitter
+{
+protected:
+  void header(const Graph &graph)
+  {
+    fragment("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+             "<!-- Generated by Edge v.0.0.1 -->\n"
+             "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+             "  <key id=\"label\" for=\"node\" attr.name=\"label\" attr.type=\"string\"/>\n"
+             "  <graph id=\"G\" edgedefault=\"undirected\">");
+
+    const string &title = graph.properties.text(PROP_TITLE);
+    if (!title.empty()) {
+      fragment("\n    <desc>");
+      xml(title.c_str());
+      fragment("</desc>");
+    }
+  }
+
+  void vertex(const Graph &graph, size_t i)
+  {
+    fragment("\n    <node id=\"");
+    xml(vertexName(graph, i));
+    fragment("\"><data key=\"label\">");
+    xml(vertexLabel(graph, i));
+    fragment("</data></node>");
+  }
+
+  void edge(const Graph &graph, const Edge &e, size_t)
+  {
+    fragment("\n    <edge source=\"");
+    xml(vertexName(graph, e.source));
+    fragment("\" target=\"");
+    xml(vertexName(graph, e.target));
+    if (e.directed)
+      fragment("\" directed=\"true\"/>");
+    else
+      fragment("\"/>");
+  }
+
+  void footer(const Graph &)
+  {
+    fragment("\n  </graph>\n</graphml>\n");
+  }
+
+private:
+  // Append text with XML special characters replaced by entities, a run of
+  // ordinary characters at a time
+  void xml(const char *text)
+  {
+    for (const char *run = text; ; text++) {
+      switch (*text) {
+        case '&': case '<': case '>': case '"': case '\'': case '\0':
+          break;
+        default:
+          continue;
+      }
+
+      buffer.append(run, text - run);
+      switch (*text) {
+        case '&':  fragment("&amp;");  break;
+        case '<':  fragment("&lt;");   break;
+        case '>':  fragment("&gt;");   break;
+        case '"':  fragment("&quot;"); break;
+        case '\'': fragment("&apos;"); break;
+        default:   return;
+      }
+      run = text + 1;
+    }
+  }
+};
+
+//*****************************************************************************
+// JSON edge list, with edges referring to vertices by position
+//*****************************************************************************
+class JsonEmitter : public Emitter
+{
+protected:
+  void header(const Graph &graph)
+  {
+    fragment("{\n  \"generator\": \"Edge v.0.0.1\",");
+
+    const string &title = graph.properties.text(PROP_TITLE);
+    if (!title.empty()) {
+      fragment("\n  \"title\": ");
+      quoted(title.c_str(), '"');
+      buffer += ',';
+    }
+    fragment("\n  \"nodes\": [");
+  }
+
+  void vertex(const Graph &graph, size_t i)
+  {
+    if (i)
+      buffer += ',';
+    fragment("\n    {\"id\": ");
+    quoted(vertexName(graph, i), '"');
+    fragment(", \"label\": ");
+    quoted(vertexLabel(graph, i), '"');
+    buffer += '}';
+  }
+
+  void edges(const Graph &graph)
+  {
+    if (!graph.vertices.empty())
+      fragment("\n  ");
+    fragment("],\n  \"edges\": [");
+  }
+
+  void edge(const Graph &, const Edge &e, size_t i)
+  {
+    if (i)
+      buffer += ',';
+    fragment("\n    {\"source\": ");
+    number(e.source);
+    fragment(", \"target\": ");
+    number(e.target);
+    if (e.directed)
+      fragment(", \"directed\": true}");
+    else
+      fragment(", \"directed\": false}");
+  }
+
+  void footer(const Graph &graph)
+  {
+    if (!graph.edges.empty())
+      fragment("\n  ");
+    fragment("]\n}\n");
+  }
+};
+
+//*****************************************************************************
+Emitter *makeEmitter(const string &format)
+{
+  if (format == "js")
+    return new JsEmitter();
+  if (format == "dot")
+    return new DotEmitter();
+  if (format == "graphml")
+    return new GraphMLEmitter();
+  if (format == "json")
+    return new JsonEmitter();
+  return NULL;
+}
@@ -0,0 +1,116 @@
+//*****************************************************************************
+// Edge language output emitters
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef EMIT_H
+#define EMIT_H
+
+#include <string>
+
+#include "graph.h"
+#include "output.h"
+
+// Size at which an emitter hands its buffer to the output file, which then
+// writes it without copying it
+#define EMIT_FLUSH_SIZE OUTPUT_BUFFER_SIZE
+
+//*****************************************************************************
+// Emitter base class
+//
+// An emitter walks the parsed graph once, appending each record to a single
+// buffer which is handed to the output file whenever it fills up and then
+// reused. Backends only format records; they never touch the file. Records
+// are built from constant fragments, names and numbers appended in place,
+// so formatting one does not allocate once the buffer has grown.
+//*****************************************************************************
+class Emitter
+{
+public:
+  Emitter ();
+  virtual ~Emitter () {}
+
+  // Write the whole graph to out
+  void emit ( const Graph &, OutputFile & );
+
+  // Write the whole graph to out, with the edges already formatted by
+  // formatEdges, unless formatsEdgesAlone says they must be written again
+  void emit ( const Graph &, OutputFile &, const std::string & );
+
+  // Append the whole graph, as emit would write it, to a string
+  void format ( const Graph &, std::string & );
+
+  // Whether edges can be formatted before the whole graph is known
+  virtual bool formatsEdgesEarly ( void ) const { return true; }
+
+  // Whether formatting the graph's edges by themselves, with formatEdges,
+  // gives what emit writes for them
+  virtual bool formatsEdgesAlone ( const Graph & ) const { return true; }
+
+  // Write each graph as a part of one that other output creates, as a shard
+  // is. Only formats that build the graph as they go write a part
+  // differently; the others write a whole document all the same.
+  void setPart(bool isPart)
+  {
+    part = isPart;
+  }
+
+  // Append a range of edges, formatted as emit would, to a string
+  void formatEdges ( const Graph &, size_t, size_t, std::string & );
+
+  // The other pieces of the output, for formatting it in parts: the header,
+  // a range of vertices, what comes between vertices and edges, and the
+  // footer
+  void formatHeader ( const Graph &, std::string & );
+  void formatVertices ( const Graph &, size_t, size_t, std::string & );
+  void formatEdgeHeader ( const Graph &, std::string & );
+  void formatFooter ( const Graph &, std::string & );
+
+protected:
+  // Called before and after emit writes the whole graph, but not when it is
+  // formatted in parts, so a backend can write some records in a form that
+  // needs the whole graph
+  virtual void begin ( const Graph & ) {}
+  virtual void end ( void ) {}
+
+  virtual void header ( const Graph & ) = 0;
+  virtual void vertex ( const Graph &, size_t ) = 0;
+  virtual void edges ( const Graph & ) {}
+  virtual void edge ( const Graph &, const Edge &, size_t ) = 0;
+  virtual void footer ( const Graph & ) = 0;
+
+  // Append a constant fragment, whose length is known when compiling
+  template <size_t N>
+  void fragment(const char (&literal)[N])
+  {
+    buffer.append(literal, N - 1);
+  }
+
+  void text(const char *name)
+  {
+    buffer.append(name);
+  }
+
+  // Append text with the given quote character and backslash escaped
+  void quoted ( const char *, char );
+
+  // Append a number in decimal, without making a string of it
+  void number ( size_t );
+
+  std::string buffer;   // reusable output buffer
+  bool        part;     // the graph is a part of one created elsewhere
+
+private:
+  // Format the whole graph, flushing to out if there is one
+  void write ( const Graph & );
+
+  void flush ( void );
+
+  OutputFile *out;
+};
+
+// Create the emitter for a format name (js, dot, graphml, json), or NULL
+// if the format is unknown
+Emitter *makeEmitter ( const std::string & );
+
+#endif
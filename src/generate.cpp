@@ -0,0 +1,200 @@
+//*****************************************************************************
+// Edge language generators
+// written by Josh Hawkins
+//*****************************************************************************
+#include <stdio.h>
+#include <charconv>
+#include <vector>
+
+#include "generate.h"
+
+using namespace std;
+
+// Message thrown for a generator called with the wrong arguments
+static char generatorError[1024];
+
+//*****************************************************************************
+// Replace what follows the prefix of a name with a number
+static void numberName(string &name, size_t prefix, int64_t number)
+{
+  if (number < 0)
+    throw "generated vertex numbers cannot be negative";
+
+  char digits[24];
+  char *end = to_chars(digits, digits + sizeof(digits), number).ptr;
+  name.resize(prefix);
+  name.append(digits, end - digits);
+}
+//*****************************************************************************
+// The vertex named by a prefix and a number, created the first time
+static int numberedVertex(Graph &graph, string &name, size_t prefix,
+                          int64_t number, const string &defaultLabel)
+{
+  numberName(name, prefix, number);
+  return addVertex(graph, name.data(), name.size(), defaultLabel);
+}
+//*****************************************************************************
+static int patternVertex(Graph &graph, const VertexPattern &pattern,
+                         string &name, int64_t i, const string &defaultLabel)
+{
+  if (pattern.position >= 0)
+    return pattern.position;
+  if (!pattern.numbered)
+    return addVertex(graph, pattern.name, defaultLabel);
+  return numberedVertex(graph, name, pattern.name.size(), i + pattern.offset,
+                        defaultLabel);
+}
+//*****************************************************************************
+// Whether vertices and edges fit GENERATOR_MAX_BYTES, checked before any
+// room is reserved for them
+static bool fits(uint64_t vertices, uint64_t edges)
+{
+  return vertices <= GENERATOR_MAX_BYTES / VERTEX_BYTES_BUDGET &&
+         edges <= GENERATOR_MAX_BYTES / EDGE_BYTES_BUDGET &&
+         vertices * VERTEX_BYTES_BUDGET + edges * EDGE_BYTES_BUDGET <=
+           GENERATOR_MAX_BYTES;
+}
+//*****************************************************************************
+size_t generateLoop(Graph &graph, const EdgeLoop &loop, bool directed,
+                    const string &defaultLabel)
+{
+  if (loop.last < loop.first)
+    return 0;
+
+  // Each numbered endpoint may name a new vertex every time round
+  uint64_t count = (uint64_t) (loop.last - loop.first) + 1;
+  uint64_t numbered = loop.source.numbered + loop.target.numbered;
+  if (count > GENERATOR_MAX_BYTES || !fits(count * numbered, count))
+    throw "loop adds too many edges";
+  graph.edges.reserve(graph.edges.size() + count);
+
+  // Names are built in place, after the prefix of each pattern
+  string source = loop.source.name, target = loop.target.name;
+  for (int64_t i = loop.first; i <= loop.last; i++) {
+    int from = patternVertex(graph, loop.source, source, i, defaultLabel);
+    int to = patternVertex(graph, loop.target, target, i, defaultLabel);
+    addEdge(graph, from, to, directed);
+  }
+  return count;
+}
+//*****************************************************************************
+// Check the numbers given to a generator, which are all sizes, and the
+// number of edges they make
+static void checkArguments(const GeneratorCall &call, int expected)
+{
+  if (call.count != expected) {
+    snprintf(generatorError, sizeof(generatorError),
+             "%s takes %d number%s, then an optional vertex name",
+             call.name.c_str(), expected, expected == 1 ? "" : "s");
+    throw (char const *) generatorError;
+  }
+
+  uint64_t vertices = 1;
+  for (int i = 0; i < call.count; i++) {
+    if (call.numbers[i] < 1)
+      throw "generator sizes must be at least 1";
+    if (call.numbers[i] > MAX_VERTICES)
+      throw "generator makes too many vertices";
+    vertices *= call.numbers[i];
+  }
+  if (vertices > MAX_VERTICES)
+    throw "generator makes too many vertices";
+}
+//*****************************************************************************
+static void checkSize(uint64_t vertices, uint64_t edges)
+{
+  if (!fits(vertices, edges))
+    throw "generator makes too large a graph";
+}
+//*****************************************************************************
+size_t generateStructure(Graph &graph, const GeneratorCall &call,
+                         bool directed, const string &defaultLabel)
+{
+  string name = call.prefix.empty() ? GENERATOR_PREFIX : call.prefix;
+  size_t prefix = name.size();
+  size_t before = graph.edges.size();
+
+  Structure structure;
+  structure.firstVertex = graph.vertices.size();
+  structure.firstEdge = before;
+  structure.width = 0;
+  structure.directed = directed;
+
+  // V1 -> V2 -> ... -> Vn, and Vn -> V1 to close a ring
+  if (call.name == "chain" || call.name == "ring") {
+    checkArguments(call, 1);
+    int64_t n = call.numbers[0];
+
+    // Smaller rings would close on a self-loop or a doubled edge
+    if (call.name == "ring" && n < 3)
+      throw "ring needs at least 3 vertices";
+    checkSize(n, n);
+    graph.edges.reserve(before + n);
+
+    int first = numberedVertex(graph, name, prefix, 1, defaultLabel);
+    int previous = first;
+    for (int64_t i = 2; i <= n; i++) {
+      int next = numberedVertex(graph, name, prefix, i, defaultLabel);
+      addEdge(graph, previous, next, directed);
+      previous = next;
+    }
+    if (call.name == "ring")
+      addEdge(graph, previous, first, directed);
+    structure.kind = call.name == "ring" ? STRUCTURE_RING : STRUCTURE_CHAIN;
+    structure.vertices = n;
+  }
+
+  // Rows top to bottom, each vertex joined to the next in its row and the
+  // one below it
+  else if (call.name == "grid") {
+    checkArguments(call, 2);
+    int64_t width = call.numbers[0], height = call.numbers[1];
+    uint64_t edges = (width - 1) * height + width * (height - 1);
+    checkSize(width * height, edges);
+    graph.edges.reserve(before + edges);
+
+    // Positions of the row above, replaced one by one by the current row
+    vector<int> above(width);
+    for (int64_t row = 1; row <= height; row++) {
+      numberName(name, prefix, row);
+      name += '_';
+      size_t rowPrefix = name.size();
+      for (int64_t column = 1; column <= width; column++) {
+        int position = numberedVertex(graph, name, rowPrefix, column,
+                                      defaultLabel);
+        if (column > 1)
+          addEdge(graph, above[column - 2], position, directed);
+        if (row > 1)
+          addEdge(graph, above[column - 1], position, directed);
+        above[column - 1] = position;
+      }
+    }
+    structure.kind = STRUCTURE_GRID;
+    structure.vertices = width * height;
+    structure.width = width;
+  }
+
+  // Every pair of vertices joined once, the lower numbered first
+  else {
+    checkArguments(call, 1);
+    int64_t n = call.numbers[0];
+    checkSize(n, (uint64_t) n * (n - 1) / 2);
+    graph.edges.reserve(before + n * (n - 1) / 2);
+
+    vector<int> positions(n);
+    for (int64_t i = 0; i < n; i++)
+      positions[i] = numberedVertex(graph, name, prefix, i + 1, defaultLabel);
+    for (int64_t i = 0; i < n; i++)
+      for (int64_t j = i + 1; j < n; j++)
+        addEdge(graph, positions[i], positions[j], directed);
+    structure.kind = STRUCTURE_COMPLETE;
+    structure.vertices = n;
+  }
+
+  // Only a structure of new vertices is a run of positions its shape
+  // describes; one reusing vertices is left as plain edges
+  structure.edges = graph.edges.size() - before;
+  if (graph.vertices.size() - structure.firstVertex == structure.vertices)
+    graph.structures.push_back(structure);
+  return structure.edges;
+}
@@ -0,0 +1,71 @@
+//*****************************************************************************
+// Edge language generators
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef GENERATE_H
+#define GENERATE_H
+
+#include <stdint.h>
+#include <string>
+
+#include "graph.h"
+
+// Most memory a single loop or generator may add, at the vertex and edge
+// budgets --mem-report checks, so a slip of the finger fails at once rather
+// than exhausting memory
+#define GENERATOR_MAX_BYTES ((uint64_t) 1 << 30)
+
+// Largest number, either way from 0, a loop or generator may be given, so
+// sums of two cannot overflow
+#define GENERATOR_MAX_NUMBER ((int64_t) 1 << 62)
+
+// Most arguments a generator takes
+#define GENERATOR_MAX_ARGUMENTS 3
+
+// Prefix of generated vertex names when a generator is not given one
+#define GENERATOR_PREFIX "V"
+
+// An endpoint of the edge in a loop: a vertex found when the loop was
+// parsed, a vertex named outright, or a name followed by the loop variable
+// plus an offset, e.g. N{i+1}
+struct VertexPattern {
+  int         position;   // vertex found by label or _, or -1
+  std::string name;       // vertex name, or the prefix of a numbered one
+  bool        numbered;   // the loop variable is appended to the name
+  int64_t     offset;     // added to the loop variable
+};
+
+// for variable in first..last: source -> target
+struct EdgeLoop {
+  std::string   variable;
+  int64_t       first;
+  int64_t       last;
+  VertexPattern source;
+  VertexPattern target;
+  int           patterns;   // patterns parsed so far
+};
+
+// chain(n), ring(n), grid(w, h) or complete(n), with an optional vertex
+// name prefix as the last argument
+struct GeneratorCall {
+  std::string name;
+  int64_t     numbers[GENERATOR_MAX_ARGUMENTS];
+  int         count;        // numbers given
+  std::string prefix;       // empty if not given
+};
+
+// Add the edges of a loop, one for each number of its range, creating the
+// vertices they name. Returns the number of edges added; failures throw a
+// message.
+size_t generateLoop ( Graph &, const EdgeLoop &, bool, const std::string & );
+
+// Add the vertices and edges of a regular structure, recording it in the
+// graph's structures when its vertices are all new. Vertices are named by
+// the prefix and their numbers from 1, row and column for a grid, e.g. V3
+// or V2_5, which the lexer reads back as vertex names. A ring has at least
+// 3 vertices. Returns the number of edges added; failures throw a message.
+size_t generateStructure ( Graph &, const GeneratorCall &, bool,
+                           const std::string & );
+
+#endif
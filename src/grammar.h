@@ -0,0 +1,435 @@
+//*****************************************************************************
+// Edge language grammar and LL(1) parse table
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef GRAMMAR_H
+#define GRAMMAR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lexer.h"
+
+//*****************************************************************************
+// Grammar symbols
+//*****************************************************************************
+
+// Terminals, the columns of the parse table. Each must fit a 32-bit set.
+enum Terminal {
+  T_VERTEX,
+  T_IDENTIFIER,
+  T_IMPLICIT,
+  T_STRING,
+  T_NUMBER,
+  T_ARROW,
+  T_CUBE,
+  T_COLON,
+  T_COMMENT,
+  T_COMMENT_START,
+  T_BEGIN,
+  T_END,
+  T_TRUE,
+  T_FALSE,
+  T_IMPORT,
+  T_INCLUDE,
+  T_FOR,
+  T_GENERATOR,
+  T_RANGE,
+  T_PLUS,
+  T_MINUS,
+  T_COMMA,
+  T_OPEN_BRACE,
+  T_CLOSE_BRACE,
+  T_OPEN_PAREN,
+  T_CLOSE_PAREN,
+  T_EOF,
+  T_OTHER,            // any token the grammar has no use for
+  TERMINAL_COUNT,
+  T_ANY = TERMINAL_COUNT  // matches any token but the end of file
+};
+
+// Nonterminals, the rows of the parse table
+enum Nonterminal {
+  N_PROGRAM = TERMINAL_COUNT + 1,
+  N_STATEMENTS,
+  N_STATEMENT,
+  N_EDGE,
+  N_VERTEX_TAIL,
+  N_ASSIGNMENT,
+  N_ARROW,
+  N_TARGET,
+  N_COMMENT,
+  N_MULTILINE,
+  N_SECTION,
+  N_RULES,
+  N_RULE,
+  N_COLON,
+  N_VALUE,
+  N_IMPORT,
+  N_IMPORT_FILE,
+  N_INCLUDE,
+  N_INCLUDE_FILE,
+  N_COMMAND,
+  N_COMMAND_FILE,
+  N_LOOP,
+  N_LOOP_RANGE,
+  N_LOOP_END,
+  N_LOOP_BODY,
+  N_PATTERN,
+  N_PATTERN_INDEX,
+  N_OFFSET,
+  N_GENERATOR,
+  N_ARGUMENTS,
+  N_MORE_ARGUMENTS,
+  N_ARGUMENT,
+  NONTERMINAL_END
+};
+
+#define NONTERMINAL_COUNT (NONTERMINAL_END - N_PROGRAM)
+
+// Semantic actions, run when they come off the parse stack. Each works on
+// the tokens matched just before it.
+enum Action {
+  ACT_SOURCE = NONTERMINAL_END,   // resolve the source of an edge
+  ACT_EDGE,                       // resolve the target and add the edge
+  ACT_ASSIGN,                     // label a vertex and bind it to _
+  ACT_PROPERTY,                   // set a config property
+  ACT_SKIP_LINE,                  // skip the rest of a | comment
+  ACT_SKIP_BLOCK,                 // skip to the end of a |- comment
+  ACT_IMPORT,                     // import an edge list
+  ACT_INCLUDE,                    // include a module
+  ACT_COMMAND,                    // save or load the session
+  ACT_LOOP_VARIABLE,              // name the variable of a loop
+  ACT_LOOP_RANGE,                 // set the numbers a loop runs over
+  ACT_PATTERN,                    // start a vertex pattern of a loop
+  ACT_OFFSET,                     // number a pattern by the loop variable
+  ACT_LOOP,                       // add the edges of a loop
+  ACT_GENERATOR,                  // start a generator call
+  ACT_ARGUMENT,                   // add an argument to a generator call
+  ACT_GENERATE,                   // add the vertices and edges generated
+  ACTION_END
+};
+
+inline constexpr bool isTerminal(int symbol)
+{
+  return symbol <= T_ANY;
+}
+
+inline constexpr bool isNonterminal(int symbol)
+{
+  return symbol >= N_PROGRAM && symbol < NONTERMINAL_END;
+}
+
+// Map a token code onto the terminal it stands for
+inline int terminalOf(int token)
+{
+  switch (token) {
+    case TOK_VERTEX:        return T_VERTEX;
+    case TOK_IDENTIFIER:    return T_IDENTIFIER;
+    case TOK_IMPLICIT:      return T_IMPLICIT;
+    case TOK_STRING:        return T_STRING;
+    case TOK_NUMBER:        return T_NUMBER;
+    case TOK_ARROW:         return T_ARROW;
+    case TOK_CUBE:          return T_CUBE;
+    case TOK_COLON:         return T_COLON;
+    case TOK_COMMENT:       return T_COMMENT;
+    case TOK_COMMENT_START: return T_COMMENT_START;
+    case TOK_BEGIN:         return T_BEGIN;
+    case TOK_END:           return T_END;
+    case TOK_TRUE:          return T_TRUE;
+    case TOK_FALSE:         return T_FALSE;
+    case TOK_IMPORT:        return T_IMPORT;
+    case TOK_INCLUDE:       return T_INCLUDE;
+    case TOK_FOR:           return T_FOR;
+    case TOK_GENERATOR:     return T_GENERATOR;
+    case TOK_RANGE:         return T_RANGE;
+    case TOK_PLUS:          return T_PLUS;
+    case TOK_MINUS:         return T_MINUS;
+    case TOK_COMMA:         return T_COMMA;
+    case TOK_OPEN_BRACE:    return T_OPEN_BRACE;
+    case TOK_CLOSE_BRACE:   return T_CLOSE_BRACE;
+    case TOK_OPEN_PAREN:    return T_OPEN_PAREN;
+    case TOK_CLOSE_PAREN:   return T_CLOSE_PAREN;
+    case TOK_EOF:           return T_EOF;
+  }
+  return T_OTHER;
+}
+
+//*****************************************************************************
+// The grammar
+//
+// This is the only definition of the language; the FIRST and FOLLOW sets
+// and the parse table below are computed from it by the compiler. It is
+// edge_prodrules.md, left factored so one token picks each production.
+//*****************************************************************************
+
+// Longest right hand side
+#define MAX_RHS 4
+
+struct Production {
+  int lhs;
+  int length;
+  int rhs[MAX_RHS];
+};
+
+constexpr Production grammar[] = {
+  // P --> {S}
+  { N_PROGRAM,      2, { N_STATEMENTS, T_EOF } },
+  { N_STATEMENTS,   2, { N_STATEMENT, N_STATEMENTS } },
+  { N_STATEMENTS,   0, { } },
+
+  // S --> A | E | C | M | G | I | U | K | L | W
+  { N_STATEMENT,    1, { N_EDGE } },
+  { N_STATEMENT,    2, { T_VERTEX, N_VERTEX_TAIL } },
+  { N_STATEMENT,    1, { N_COMMENT } },
+  { N_STATEMENT,    1, { N_MULTILINE } },
+  { N_STATEMENT,    1, { N_SECTION } },
+  { N_STATEMENT,    1, { N_IMPORT } },
+  { N_STATEMENT,    1, { N_INCLUDE } },
+  { N_STATEMENT,    1, { N_COMMAND } },
+  { N_STATEMENT,    1, { N_LOOP } },
+  { N_STATEMENT,    1, { N_GENERATOR } },
+
+  // E --> ID | VERTEX | _ -> (ID | VERTEX | _)
+  { N_EDGE,         2, { T_IDENTIFIER, N_ARROW } },
+  { N_EDGE,         2, { T_IMPLICIT, N_ARROW } },
+  { N_VERTEX_TAIL,  2, { T_CUBE, N_ASSIGNMENT } },
+  { N_VERTEX_TAIL,  1, { N_ARROW } },
+  { N_ARROW,        3, { T_ARROW, ACT_SOURCE, N_TARGET } },
+  { N_TARGET,       2, { T_VERTEX, ACT_EDGE } },
+  { N_TARGET,       2, { T_IDENTIFIER, ACT_EDGE } },
+  { N_TARGET,       2, { T_IMPLICIT, ACT_EDGE } },
+
+  // A --> VERTEX :: [ ID ]
+  { N_ASSIGNMENT,   2, { T_IDENTIFIER, ACT_ASSIGN } },
+  { N_ASSIGNMENT,   1, { ACT_ASSIGN } },
+
+  // C --> \| { . }
+  { N_COMMENT,      2, { T_COMMENT, ACT_SKIP_LINE } },
+
+  // M --> \|- { . } -\|
+  { N_MULTILINE,    2, { T_COMMENT_START, ACT_SKIP_BLOCK } },
+
+  // G --> begin LABEL { R } end
+  { N_SECTION,      4, { T_BEGIN, T_ANY, N_RULES, T_END } },
+  { N_RULES,        2, { N_RULE, N_RULES } },
+  { N_RULES,        0, { } },
+
+  // R --> PROPERTY : true | false | NUMBER | STRING
+  { N_RULE,         2, { T_IDENTIFIER, N_COLON } },
+  { N_COLON,        2, { T_COLON, N_VALUE } },
+  { N_VALUE,        2, { T_TRUE, ACT_PROPERTY } },
+  { N_VALUE,        2, { T_FALSE, ACT_PROPERTY } },
+  { N_VALUE,        2, { T_NUMBER, ACT_PROPERTY } },
+  { N_VALUE,        2, { T_STRING, ACT_PROPERTY } },
+
+  // I --> import STRING
+  { N_IMPORT,       2, { T_IMPORT, N_IMPORT_FILE } },
+  { N_IMPORT_FILE,  2, { T_STRING, ACT_IMPORT } },
+
+  // U --> include STRING
+  { N_INCLUDE,      2, { T_INCLUDE, N_INCLUDE_FILE } },
+  { N_INCLUDE_FILE, 2, { T_STRING, ACT_INCLUDE } },
+
+  // K --> : (save | load) STRING
+  { N_COMMAND,      3, { T_COLON, T_IDENTIFIER, N_COMMAND_FILE } },
+  { N_COMMAND_FILE, 2, { T_STRING, ACT_COMMAND } },
+
+  // L --> for ID in NUMBER .. NUMBER : T -> T
+  { N_LOOP,         4, { T_FOR, T_IDENTIFIER, T_IDENTIFIER, N_LOOP_RANGE } },
+  { N_LOOP_RANGE,   4, { ACT_LOOP_VARIABLE, T_NUMBER, T_RANGE, N_LOOP_END } },
+  { N_LOOP_END,     4, { T_NUMBER, ACT_LOOP_RANGE, T_COLON, N_LOOP_BODY } },
+  { N_LOOP_BODY,    4, { N_PATTERN, T_ARROW, N_PATTERN, ACT_LOOP } },
+
+  // T --> VERTEX [ { ID [+ NUMBER | - NUMBER | NUMBER] } ] | ID | _
+  { N_PATTERN,      3, { T_VERTEX, ACT_PATTERN, N_PATTERN_INDEX } },
+  { N_PATTERN,      2, { T_IDENTIFIER, ACT_PATTERN } },
+  { N_PATTERN,      2, { T_IMPLICIT, ACT_PATTERN } },
+  { N_PATTERN_INDEX, 4, { T_OPEN_BRACE, T_IDENTIFIER, N_OFFSET, T_CLOSE_BRACE } },
+  { N_PATTERN_INDEX, 0, { } },
+  { N_OFFSET,       3, { T_PLUS, T_NUMBER, ACT_OFFSET } },
+  { N_OFFSET,       3, { T_MINUS, T_NUMBER, ACT_OFFSET } },
+  { N_OFFSET,       2, { T_NUMBER, ACT_OFFSET } },
+  { N_OFFSET,       1, { ACT_OFFSET } },
+
+  // W --> GENERATOR ( NUMBER | VERTEX {, NUMBER | VERTEX} )
+  { N_GENERATOR,    4, { T_GENERATOR, ACT_GENERATOR, T_OPEN_PAREN, N_ARGUMENTS } },
+  { N_ARGUMENTS,    2, { N_ARGUMENT, N_MORE_ARGUMENTS } },
+  { N_MORE_ARGUMENTS, 3, { T_COMMA, N_ARGUMENT, N_MORE_ARGUMENTS } },
+  { N_MORE_ARGUMENTS, 2, { T_CLOSE_PAREN, ACT_GENERATE } },
+  { N_ARGUMENT,     2, { T_NUMBER, ACT_ARGUMENT } },
+  { N_ARGUMENT,     2, { T_VERTEX, ACT_ARGUMENT } },
+};
+
+#define PRODUCTION_COUNT ((int) (sizeof(grammar) / sizeof(grammar[0])))
+
+// Name printed in the parse tree (none for lists), and the message thrown
+// when the current token starts none of the productions, for each
+// nonterminal
+struct NonterminalInfo {
+  const char *name;
+  const char *error;
+};
+
+constexpr NonterminalInfo nonterminals[NONTERMINAL_COUNT] = {
+  { "P", "unrecognized symbol at start of program" },
+  { NULL, "end of file expected, but there is more here!" },
+  { "S", "statement does not start with 'begin', '|', '|-', or vertex" },
+  { "E", "edge does not begin with vertex, identifier or _" },
+  { "A|E", "vertex is not followed by :: or ->" },
+  { "A", "assignment is not followed by an identifier" },
+  { "->", "edge does not have arrow following vertex or ID" },
+  { "target", "edge target does not begin with vertex, identifier or _" },
+  { "C", "comment does not start with |" },
+  { "M", "comment does not start with |-" },
+  { "G", "section does not start with 'begin'" },
+  { NULL, "R does not begin with valid property" },
+  { "R", "R does not begin with valid property" },
+  { ":", "did not find : after property" },
+  { "value", "property not set to true, false, a number or a string" },
+  { "I", "import does not start with 'import'" },
+  { "file", "import is not followed by a quoted file name" },
+  { "U", "include does not start with 'include'" },
+  { "module", "include is not followed by a quoted file name" },
+  { "K", "command does not start with ':'" },
+  { "session", "command is not followed by a quoted file name" },
+  { "L", "loop does not start with 'for'" },
+  { NULL, "loop range does not start with a number" },
+  { NULL, "loop range does not end with a number" },
+  { "body", "loop body is not an edge" },
+  { "T", "loop edge does not begin with vertex, identifier or _" },
+  { NULL, "loop vertex is followed by neither an index in braces nor ->" },
+  { NULL, "vertex index is not the loop variable plus or minus a number" },
+  { "W", "generator does not start with chain, ring, grid or complete" },
+  { NULL, "generator has no arguments" },
+  { NULL, "generator arguments are not separated by commas and closed by )" },
+  { NULL, "generator argument is not a number or a vertex" },
+};
+
+//*****************************************************************************
+// Parse table construction
+//*****************************************************************************
+
+// FIRST and FOLLOW sets, as bit sets of terminals, and the production to
+// expand for each nonterminal and lookahead terminal, or -1
+struct ParseTable {
+  uint32_t    first[NONTERMINAL_COUNT];
+  uint32_t    follow[NONTERMINAL_COUNT];
+  bool        nullable[NONTERMINAL_COUNT];
+  signed char entry[NONTERMINAL_COUNT][TERMINAL_COUNT];
+  bool        conflict;   // two productions compete for one entry
+};
+
+// FIRST set of rhs[from...] of a production; nullable is set if every
+// symbol there can derive the empty string. Actions derive nothing.
+constexpr uint32_t firstOfRhs(const ParseTable &table, const Production &p,
+                              int from, bool &nullable)
+{
+  uint32_t first = 0;
+
+  for (int i = from; i < p.length; i++) {
+    int symbol = p.rhs[i];
+
+    if (isTerminal(symbol)) {
+      first |= symbol == T_ANY ? ((1u << TERMINAL_COUNT) - 1) & ~(1u << T_EOF)
+                               : 1u << symbol;
+      nullable = false;
+      return first;
+    }
+
+    if (isNonterminal(symbol)) {
+      first |= table.first[symbol - N_PROGRAM];
+      if (!table.nullable[symbol - N_PROGRAM]) {
+        nullable = false;
+        return first;
+      }
+    }
+  }
+
+  nullable = true;
+  return first;
+}
+//*****************************************************************************
+constexpr ParseTable buildParseTable()
+{
+  ParseTable table = {};
+  bool changed = true;
+
+  // FIRST sets and nullable nonterminals, to a fixed point
+  while (changed) {
+    changed = false;
+    for (int p = 0; p < PRODUCTION_COUNT; p++) {
+      int lhs = grammar[p].lhs - N_PROGRAM;
+      bool nullable = false;
+      uint32_t first = firstOfRhs(table, grammar[p], 0, nullable);
+
+      if ((table.first[lhs] | first) != table.first[lhs] ||
+          (nullable && !table.nullable[lhs])) {
+        table.first[lhs] |= first;
+        table.nullable[lhs] = table.nullable[lhs] || nullable;
+        changed = true;
+      }
+    }
+  }
+
+  // FOLLOW sets, to a fixed point
+  table.follow[0] = 1u << T_EOF;
+  changed = true;
+  while (changed) {
+    changed = false;
+    for (int p = 0; p < PRODUCTION_COUNT; p++) {
+      const Production &production = grammar[p];
+      for (int i = 0; i < production.length; i++) {
+        if (!isNonterminal(production.rhs[i]))
+          continue;
+
+        bool nullable = false;
+        uint32_t follow = firstOfRhs(table, production, i + 1, nullable);
+        if (nullable)
+          follow |= table.follow[production.lhs - N_PROGRAM];
+
+        uint32_t &set = table.follow[production.rhs[i] - N_PROGRAM];
+        if ((set | follow) != set) {
+          set |= follow;
+          changed = true;
+        }
+      }
+    }
+  }
+
+  for (int n = 0; n < NONTERMINAL_COUNT; n++)
+    for (int t = 0; t < TERMINAL_COUNT; t++)
+      table.entry[n][t] = -1;
+
+  // A production is chosen on its FIRST set. An empty production is also
+  // chosen on the FOLLOW set of its nonterminal, but only where no other
+  // production applies, so [ ID ] takes an identifier when it can.
+  for (int pass = 0; pass < 2; pass++) {
+    for (int p = 0; p < PRODUCTION_COUNT; p++) {
+      int lhs = grammar[p].lhs - N_PROGRAM;
+      bool nullable = false;
+      uint32_t first = firstOfRhs(table, grammar[p], 0, nullable);
+      uint32_t lookahead = pass == 0 ? first : nullable ? table.follow[lhs] : 0;
+
+      for (int t = 0; t < TERMINAL_COUNT; t++) {
+        if (!(lookahead & (1u << t)))
+          continue;
+        if (table.entry[lhs][t] < 0)
+          table.entry[lhs][t] = p;
+        else if (pass == 0 && table.entry[lhs][t] != p)
+          table.conflict = true;
+      }
+    }
+  }
+
+  return table;
+}
+
+constexpr ParseTable parseTable = buildParseTable();
+
+static_assert(TERMINAL_COUNT <= 32, "terminal sets are 32-bit");
+static_assert(PRODUCTION_COUNT < 128, "parse table entries are signed chars");
+static_assert(!parseTable.conflict, "the Edge grammar is not LL(1)");
+
+#endif
@@ -0,0 +1,349 @@
+//*****************************************************************************
+// Edge language graph store
+// written by Josh Hawkins
+//*****************************************************************************
+#include <string.h>
+
+#include "graph.h"
+
+using namespace std;
+
+// Slot markers in a TextIndex
+#define EMPTY_SLOT   0
+#define DELETED_SLOT 1
+
+// Gives the string a TextIndex value stands for
+typedef const char *(*TextOfT)( const Graph &, uint32_t );
+
+//*****************************************************************************
+// Hash table helpers
+//*****************************************************************************
+static const char *nameOf(const Graph &graph, uint32_t position)
+{
+  return vertexName(graph, position);
+}
+//*****************************************************************************
+static const char *labelOf(const Graph &graph, uint32_t position)
+{
+  return vertexLabel(graph, position);
+}
+//*****************************************************************************
+static const char *textAt(const Graph &graph, uint32_t offset)
+{
+  return &graph.text[offset];
+}
+//*****************************************************************************
+// FNV-1a
+static uint32_t hashText(const char *text, size_t length)
+{
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= (unsigned char) text[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+//*****************************************************************************
+// Find the slot holding key, or the slot a new key should take. The table
+// must have at least one empty slot.
+static size_t probe(const Graph &graph, const TextIndex &index, TextOfT textOf,
+                    const char *key, size_t length, bool &found)
+{
+  size_t mask = index.slots.size() - 1;
+  size_t i = hashText(key, length) & mask;
+  size_t reuse = index.slots.size();
+
+  for (;;) {
+    uint32_t slot = index.slots[i];
+
+    if (slot == EMPTY_SLOT) {
+      found = false;
+      return reuse < index.slots.size() ? reuse : i;
+    }
+
+    if (slot == DELETED_SLOT) {
+      if (reuse == index.slots.size())
+        reuse = i;
+    } else {
+      const char *text = textOf(graph, slot - 2);
+      if (strncmp(text, key, length) == 0 && text[length] == '\0') {
+        found = true;
+        return i;
+      }
+    }
+
+    i = (i + 1) & mask;
+  }
+}
+//*****************************************************************************
+static int lookup(const Graph &graph, const TextIndex &index, TextOfT textOf,
+                  const char *key, size_t length)
+{
+  if (index.slots.empty())
+    return -1;
+
+  bool found;
+  size_t i = probe(graph, index, textOf, key, length, found);
+  return found ? (int) (index.slots[i] - 2) : -1;
+}
+//*****************************************************************************
+// Make room for one more key, keeping the table at most half full
+static void reserveSlot(const Graph &graph, TextIndex &index, TextOfT textOf)
+{
+  if ((index.used + 1) * 2 <= index.slots.size())
+    return;
+
+  vector<uint32_t> old;
+  old.swap(index.slots);
+  index.slots.assign(old.empty() ? 16 : old.size() * 2, EMPTY_SLOT);
+  index.used = 0;
+
+  for (size_t i = 0; i < old.size(); i++) {
+    if (old[i] == EMPTY_SLOT || old[i] == DELETED_SLOT)
+      continue;
+
+    const char *text = textOf(graph, old[i] - 2);
+    size_t j = hashText(text, strlen(text)) & (index.slots.size() - 1);
+    while (index.slots[j] != EMPTY_SLOT)
+      j = (j + 1) & (index.slots.size() - 1);
+    index.slots[j] = old[i];
+    index.used++;
+  }
+}
+//*****************************************************************************
+// Set the value for key, adding it if it is not there yet
+static void store(const Graph &graph, TextIndex &index, TextOfT textOf,
+                  const char *key, size_t length, uint32_t value)
+{
+  reserveSlot(graph, index, textOf);
+
+  bool found;
+  size_t i = probe(graph, index, textOf, key, length, found);
+  if (!found && index.slots[i] == EMPTY_SLOT)
+    index.used++;
+  index.slots[i] = value + 2;
+}
+//*****************************************************************************
+static void remove(const Graph &graph, TextIndex &index, TextOfT textOf,
+                   const char *key, size_t length)
+{
+  if (index.slots.empty())
+    return;
+
+  bool found;
+  size_t i = probe(graph, index, textOf, key, length, found);
+  if (found)
+    index.slots[i] = DELETED_SLOT;
+}
+//*****************************************************************************
+// Copy a string to the end of the text, returning its offset
+static uint32_t appendText(Graph &graph, const char *text, size_t length)
+{
+  if (graph.text.size() + length + 1 > UINT32_MAX)
+    throw "graph names and labels exceed 4 GiB";
+
+  uint32_t offset = graph.text.size();
+  graph.text.insert(graph.text.end(), text, text + length);
+  graph.text.push_back('\0');
+  return offset;
+}
+//*****************************************************************************
+// Find the offset of a label, storing it if it is new
+static uint32_t internLabel(Graph &graph, const string &label)
+{
+  int offset = lookup(graph, graph.strings, textAt, label.data(), label.size());
+  if (offset >= 0)
+    return offset;
+
+  uint32_t added = appendText(graph, label.data(), label.size());
+  store(graph, graph.strings, textAt, label.data(), label.size(), added);
+  return added;
+}
+
+//*****************************************************************************
+// Graph functions
+//*****************************************************************************
+int findVertex(const Graph &graph, const char *name, size_t length)
+{
+  return lookup(graph, graph.names, nameOf, name, length);
+}
+//*****************************************************************************
+int addVertex(Graph &graph, const char *name, size_t length, const string &label)
+{
+  int position = findVertex(graph, name, length);
+  if (position >= 0)
+    return position;
+
+  // If not found, append a new vertex
+  if (graph.vertices.size() == MAX_VERTICES)
+    throw "too many vertices";
+
+  Vertex vertex;
+  vertex.name = appendText(graph, name, length);
+  vertex.label = internLabel(graph, label);
+  graph.vertices.push_back(vertex);
+
+  position = graph.vertices.size() - 1;
+  store(graph, graph.names, nameOf, name, length, position);
+  return position;
+}
+//*****************************************************************************
+void assignLabel(Graph &graph, int position, const string &label,
+                 const string &defaultLabel, bool bind)
+{
+  const char *old = vertexLabel(graph, position);
+  size_t length = strlen(old);
+  bool wasBound = findLabel(graph, old, length) == position;
+  bool bound = bind && label != defaultLabel;
+
+  if (graph.journaling) {
+    LabelChange change;
+    change.position = position;
+    change.oldLabel = graph.vertices[position].label;
+    change.oldHolder = findLabel(graph, label);
+    change.wasBound = wasBound;
+    change.bound = bound;
+    graph.labelChanges.push_back(change);
+  }
+
+  // Drop the binding of the label being replaced, if it still names us
+  if (wasBound)
+    remove(graph, graph.labels, labelOf, old, length);
+
+  graph.vertices[position].label = internLabel(graph, label);
+  if (bound)
+    store(graph, graph.labels, labelOf, label.data(), label.size(), position);
+
+  graph.current = position;
+}
+//*****************************************************************************
+int findLabel(const Graph &graph, const char *label, size_t length)
+{
+  return lookup(graph, graph.labels, labelOf, label, length);
+}
+//*****************************************************************************
+void addEdge(Graph &graph, int source, int target, bool directed)
+{
+  Edge edge;
+  edge.source = source;
+  edge.target = target;
+  edge.directed = directed;
+  edge.spare = 0;
+  graph.edges.push_back(edge);
+
+  if (directed)
+    graph.directedEdges++;
+}
+//*****************************************************************************
+void spliceGraph(Graph &graph, const Graph &module, const string &defaultLabel)
+{
+  int current = graph.current;
+  vector<int> remap(module.vertices.size());
+
+  for (size_t i = 0; i < module.vertices.size(); i++) {
+    const char *name = vertexName(module, i);
+    const char *label = vertexLabel(module, i);
+    remap[i] = addVertex(graph, name, strlen(name), defaultLabel);
+
+    // Every label the module gave carries over, but only those still
+    // bound there are bound here
+    if (label != defaultLabel)
+      assignLabel(graph, remap[i], label, defaultLabel,
+                  findLabel(module, label, strlen(label)) == (int) i);
+  }
+
+  for (size_t i = 0; i < module.edges.size(); i++) {
+    const Edge &edge = module.edges[i];
+    addEdge(graph, remap[edge.source], remap[edge.target], edge.directed);
+  }
+
+  graph.current = current;
+}
+//*****************************************************************************
+void changeProperty(Graph &graph, PropertyId id, const PropertyValue &value)
+{
+  if (graph.journaling) {
+    PropertyChange change;
+    change.id = id;
+    change.old = graph.properties.values[id];
+    graph.propertyChanges.push_back(change);
+  }
+  graph.properties.values[id] = value;
+}
+//*****************************************************************************
+GraphMark markGraph(const Graph &graph)
+{
+  GraphMark mark;
+  mark.vertices = graph.vertices.size();
+  mark.edges = graph.edges.size();
+  mark.text = graph.text.size();
+  mark.current = graph.current;
+  mark.directedEdges = graph.directedEdges;
+  mark.labelChanges = graph.labelChanges.size();
+  mark.propertyChanges = graph.propertyChanges.size();
+  mark.structures = graph.structures.size();
+  return mark;
+}
+//*****************************************************************************
+// Label changes are undone newest first, each restoring the bindings it
+// replaced; vertices, edges and text added since the mark are then cut
+// off, along with their index entries.
+void rollbackGraph(Graph &graph, const GraphMark &mark)
+{
+  while (graph.labelChanges.size() > mark.labelChanges) {
+    const LabelChange &change = graph.labelChanges.back();
+    const char *label = vertexLabel(graph, change.position);
+    size_t length = strlen(label);
+
+    if (change.bound) {
+      if (change.oldHolder >= 0)
+        store(graph, graph.labels, labelOf, label, length, change.oldHolder);
+      else
+        remove(graph, graph.labels, labelOf, label, length);
+    }
+
+    graph.vertices[change.position].label = change.oldLabel;
+    if (change.wasBound) {
+      label = vertexLabel(graph, change.position);
+      store(graph, graph.labels, labelOf, label, strlen(label), change.position);
+    }
+    graph.labelChanges.pop_back();
+  }
+
+  while (graph.propertyChanges.size() > mark.propertyChanges) {
+    const PropertyChange &change = graph.propertyChanges.back();
+    graph.properties.values[change.id] = change.old;
+    graph.propertyChanges.pop_back();
+  }
+
+  for (size_t i = graph.vertices.size(); i-- > mark.vertices; ) {
+    const char *name = vertexName(graph, i);
+    remove(graph, graph.names, nameOf, name, strlen(name));
+  }
+  graph.vertices.resize(mark.vertices);
+
+  // Forget labels interned since the mark
+  for (size_t i = 0; i < graph.strings.slots.size(); i++) {
+    uint32_t slot = graph.strings.slots[i];
+    if (slot != EMPTY_SLOT && slot != DELETED_SLOT && slot - 2 >= mark.text)
+      graph.strings.slots[i] = DELETED_SLOT;
+  }
+  graph.text.resize(mark.text);
+
+  graph.edges.resize(mark.edges);
+  graph.structures.resize(mark.structures);
+  graph.directedEdges = mark.directedEdges;
+  graph.current = mark.current;
+}
+//*****************************************************************************
+GraphMemory graphMemory(const Graph &graph)
+{
+  GraphMemory memory;
+  memory.vertices = graph.vertices.capacity() * sizeof(Vertex);
+  memory.edges = graph.edges.capacity() * sizeof(Edge);
+  memory.text = graph.text.capacity();
+  memory.indexes = (graph.names.slots.capacity() +
+                    graph.labels.slots.capacity() +
+                    graph.strings.slots.capacity()) * sizeof(uint32_t);
+  return memory;
+}
@@ -0,0 +1,195 @@
+//*****************************************************************************
+// Edge language graph store
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "properties.h"
+
+// Most vertices a graph can hold, so positions fit the packed edge fields
+#define MAX_VERTICES 0x7fffffff
+
+// Allocated bytes allowed per vertex and per edge, checked by --mem-report.
+// A vertex costs its record, its index slots and its name; an edge is a
+// single record, plus the slack the edge list keeps for growth.
+#define VERTEX_BYTES_BUDGET 64
+#define EDGE_BYTES_BUDGET   16
+
+// Smallest vertex or edge count a budget is checked at; below it the
+// initial sizes of the tables dominate
+#define BUDGET_MIN_COUNT    1024
+
+//*****************************************************************************
+// Graph records
+//*****************************************************************************
+
+// A vertex, in order of first appearance in the source. Both fields are
+// offsets of NUL-terminated strings in Graph::text.
+struct Vertex {
+  uint32_t name;      // name used in the source, e.g. A
+  uint32_t label;     // label shown when rendered, e.g. start
+};
+
+// An edge between two vertex positions, packed into 8 bytes
+struct Edge {
+  uint32_t source   : 31;
+  uint32_t directed : 1;    // value of the directed property when parsed
+  uint32_t target   : 31;
+  uint32_t spare    : 1;
+};
+
+// Open addressing hash table of 32-bit values, each of which stands for a
+// string in Graph::text (a vertex name or label, or a text offset)
+struct TextIndex {
+  std::vector<uint32_t> slots;  // 0 empty, 1 deleted, otherwise value + 2
+  size_t                used;   // slots that are not empty
+
+  TextIndex () : used(0) {}
+};
+
+// Shapes of the regular structures a generator builds
+enum StructureKind {
+  STRUCTURE_CHAIN,      // each vertex to the next
+  STRUCTURE_RING,       // a chain, then the last vertex to the first
+  STRUCTURE_GRID,       // each vertex to the next in its row and the one below
+  STRUCTURE_COMPLETE    // each vertex to every later one
+};
+
+// A structure built by a generator from vertices it created, so an output
+// can rebuild it from its shape instead of listing its edges. Its vertices
+// and edges are runs of consecutive positions, in the order its shape
+// gives them.
+struct Structure {
+  int      kind;          // StructureKind
+  uint32_t firstVertex;
+  uint32_t vertices;
+  uint32_t width;         // row length of a grid
+  uint32_t firstEdge;
+  uint32_t edges;
+  bool     directed;      // all of its edges are, or none are
+};
+
+// A label assignment, kept so it can be undone
+struct LabelChange {
+  int      position;    // the vertex labeled
+  uint32_t oldLabel;    // its label before, as an offset in Graph::text
+  int      oldHolder;   // vertex the new label was bound to before, or -1
+  bool     wasBound;    // the old label was bound to this vertex
+  bool     bound;       // the new label was bound
+};
+
+// A property change, kept so it can be undone
+struct PropertyChange {
+  int           id;
+  PropertyValue old;
+};
+
+// How big a graph was at some point, for rolling back to it
+struct GraphMark {
+  uint32_t vertices;
+  uint32_t edges;
+  uint32_t text;
+  int      current;
+  int      directedEdges;
+  uint32_t labelChanges;
+  uint32_t propertyChanges;
+  uint32_t structures;
+};
+
+// The parsed graph handed to the emitters
+struct Graph {
+  std::vector<Vertex> vertices;
+  std::vector<Edge>   edges;
+  std::vector<char>   text;           // vertex names and labels
+  TextIndex           names;          // vertex name -> position
+  TextIndex           labels;         // bound label -> position
+  TextIndex           strings;        // label text -> offset, to share labels
+  int                 current;        // vertex bound to _, or -1
+  int                 directedEdges;  // number of edges with directed set
+  Properties          properties;     // values set in config sections
+  std::vector<Structure> structures;  // built by generators, in order
+
+  // Changes kept while journaling, so the graph can be rolled back. Every
+  // other change only appends.
+  bool                        journaling;
+  std::vector<LabelChange>    labelChanges;
+  std::vector<PropertyChange> propertyChanges;
+
+  Graph () : current(-1), directedEdges(0), journaling(false) {}
+};
+
+// Allocated bytes held by each part of a graph
+struct GraphMemory {
+  size_t vertices;    // vertex records
+  size_t edges;       // edge records
+  size_t text;        // names and labels
+  size_t indexes;     // hash tables
+};
+
+//*****************************************************************************
+// Graph functions
+//*****************************************************************************
+
+inline const char *vertexName(const Graph &graph, size_t position)
+{
+  return &graph.text[graph.vertices[position].name];
+}
+
+inline const char *vertexLabel(const Graph &graph, size_t position)
+{
+  return &graph.text[graph.vertices[position].label];
+}
+
+// Find a vertex by name, returning its position or -1
+int findVertex ( const Graph &, const char *, size_t );
+
+// Find or create a vertex by name, returning its position. A new vertex
+// gets the given label, which is not bound.
+int addVertex ( Graph &, const char *, size_t, const std::string & );
+
+inline int addVertex(Graph &graph, const std::string &name,
+                     const std::string &label)
+{
+  return addVertex(graph, name.data(), name.size(), label);
+}
+
+// Give a vertex a new label, bind the label to it unless told not to, and
+// make it the vertex referred to by _. The default label is never bound.
+void assignLabel ( Graph &, int, const std::string &, const std::string &,
+                   bool = true );
+
+// Find the vertex bound to a label, or -1
+int findLabel ( const Graph &, const char *, size_t );
+
+inline int findLabel(const Graph &graph, const std::string &label)
+{
+  return findLabel(graph, label.data(), label.size());
+}
+
+// Append an edge between two vertex positions
+void addEdge ( Graph &, int, int, bool );
+
+// Add the vertices, labels and edges of a separately parsed graph, mapping
+// its vertex positions onto ours. What _ refers to is left unchanged.
+void spliceGraph ( Graph &, const Graph &, const std::string & );
+
+// Set a config property
+void changeProperty ( Graph &, PropertyId, const PropertyValue & );
+
+// Remember the current state of a journaling graph
+GraphMark markGraph ( const Graph & );
+
+// Undo everything done to a journaling graph since it was marked
+void rollbackGraph ( Graph &, const GraphMark & );
+
+// Measure the memory held by a graph
+GraphMemory graphMemory ( const Graph & );
+
+#endif
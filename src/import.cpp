@@ -0,0 +1,397 @@
+//*****************************************************************************
+// Edge language edge list import
+// written by Josh Hawkins
+//*****************************************************************************
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <thread>
+#include <vector>
+
+#include "import.h"
+#include "intern.h"
+
+using namespace std;
+
+// Holds the message thrown when an import fails
+static char importError[1024];
+
+static_assert(IMPORT_MAX_NAME_LENGTH <= INTERN_MAX_LENGTH,
+              "imported names must fit the vertex table");
+
+// The first problem one thread found in its part of a list
+struct ImportFailure {
+  size_t      line;       // 0 if there was none
+  const char *what;
+  const char *field;
+  size_t      length;
+};
+
+// A part of a list read by one thread, and what it found there
+struct ImportChunk {
+  const char          *begin;
+  const char          *end;
+  size_t               firstLine;   // number of the line it starts on
+  size_t               lines;
+  std::vector<int64_t> endpoints;   // source then target of each edge
+  ImportFailure        failure;
+};
+
+//*****************************************************************************
+// A read-only mapping of a whole file, released however we leave
+struct MappedFile {
+  const char *data;
+  size_t      size;
+
+  MappedFile () : data(NULL), size(0) {}
+  ~MappedFile () { if (data) munmap((void *) data, size); }
+};
+
+//*****************************************************************************
+static void fail(const string &path, size_t line, const char *what,
+                 const char *field, size_t length)
+{
+  snprintf(importError, sizeof(importError), "%s:%lu: %s '%.*s'",
+           path.c_str(), (unsigned long) line, what, (int) length, field);
+  throw (char const *) importError;
+}
+//*****************************************************************************
+static void failFile(const string &path, const char *what)
+{
+  snprintf(importError, sizeof(importError), "%s '%s'", what, path.c_str());
+  throw (char const *) importError;
+}
+//*****************************************************************************
+static void mapFile(MappedFile &file, const string &path)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    failFile(path, "cannot open edge list");
+
+  struct stat st;
+  if (fstat(fd, &st) < 0) {
+    close(fd);
+    failFile(path, "cannot read edge list");
+  }
+
+  file.size = st.st_size;
+  if (file.size > 0) {
+    void *data = mmap(NULL, file.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      close(fd);
+      failFile(path, "cannot map edge list");
+    }
+    madvise(data, file.size, MADV_SEQUENTIAL);
+    file.data = (const char *) data;
+  }
+  close(fd);
+}
+//*****************************************************************************
+static const char *skipDigits(const char *p, const char *end)
+{
+  while (p < end && *p >= '0' && *p <= '9')
+    p++;
+  return p;
+}
+//*****************************************************************************
+// Whether a field is a vertex name as the lexer reads one: capitals, then
+// optionally a number and a second number after _, e.g. V3 or V2_5
+static bool isVertexName(const char *field, size_t length)
+{
+  const char *p = field, *end = field + length;
+  while (p < end && *p >= 'A' && *p <= 'Z')
+    p++;
+  if (p == field)
+    return false;
+
+  const char *digits = skipDigits(p, end);
+  if (digits > p && digits < end && *digits == '_' &&
+      skipDigits(digits + 1, end) > digits + 1)
+    digits = skipDigits(digits + 1, end);
+  return digits == end;
+}
+//*****************************************************************************
+// Find the vertex for one field, creating it if it is a vertex name
+static int resolve(Graph &graph, const char *field, size_t length,
+                   const string &defaultLabel, const string &path, size_t line)
+{
+  // VERTEX
+  if (isVertexName(field, length)) {
+    if (length > IMPORT_MAX_NAME_LENGTH)
+      fail(path, line, "vertex name too long", field, 32);
+    return addVertex(graph, field, length, defaultLabel);
+  }
+
+  // ID
+  if (length > 0 && field[0] >= 'a' && field[0] <= 'z') {
+    int position = findLabel(graph, field, length);
+    if (position >= 0)
+      return position;
+    fail(path, line, "undefined identifier", field, length);
+  }
+
+  fail(path, line, "expected a vertex or identifier, found", field, length);
+  return -1;
+}
+//*****************************************************************************
+// Shrink [begin, end) to exclude surrounding spaces
+static void trim(const char *&begin, const char *&end)
+{
+  while (begin < end && (*begin == ' ' || *begin == '\t'))
+    begin++;
+  while (end > begin && (end[-1] == ' ' || end[-1] == '\t'))
+    end--;
+}
+//*****************************************************************************
+// Split a line into its source and target fields, returning false if it has
+// no delimiter
+static bool splitFields(const char *p, const char *stop, char delimiter,
+                        const char *&sourceBegin, const char *&sourceEnd,
+                        const char *&targetBegin, const char *&targetEnd)
+{
+  const char *split = (const char *) memchr(p, delimiter, stop - p);
+  if (split == NULL)
+    return false;
+
+  sourceBegin = p;
+  sourceEnd = split;
+  targetBegin = split + 1;
+  targetEnd = (const char *) memchr(targetBegin, delimiter, stop - targetBegin);
+  if (targetEnd == NULL)
+    targetEnd = stop;
+  trim(sourceBegin, sourceEnd);
+  trim(targetBegin, targetEnd);
+  return true;
+}
+//*****************************************************************************
+// Parallel import
+//
+// The list is cut into one chunk per thread at line boundaries. Each thread
+// resolves its own lines against the graph, which nobody changes meanwhile,
+// and interns new vertex names in a shared VertexTable. The new vertices are
+// then added in the order their names first appear in the list, and the
+// edges in list order, so the graph comes out exactly as a single thread
+// would have built it.
+//*****************************************************************************
+static void countLines(ImportChunk *chunk)
+{
+  size_t lines = 0;
+  for (const char *p = chunk->begin; p < chunk->end; lines++) {
+    const char *eol = (const char *) memchr(p, '\n', chunk->end - p);
+    p = eol ? eol + 1 : chunk->end;
+  }
+  chunk->lines = lines;
+}
+//*****************************************************************************
+static void failChunk(ImportChunk &chunk, size_t line, const char *what,
+                      const char *field, size_t length)
+{
+  chunk.failure.line = line;
+  chunk.failure.what = what;
+  chunk.failure.field = field;
+  chunk.failure.length = length;
+}
+//*****************************************************************************
+// Find the vertex for one field without changing the graph: its position, or
+// the complement of its slot in the table if it is a new vertex name
+static bool lookup(const Graph &graph, VertexTable &table, const char *field,
+                   size_t length, uint64_t seen, ImportChunk &chunk,
+                   size_t line, int64_t &endpoint)
+{
+  // VERTEX
+  if (isVertexName(field, length)) {
+    if (length > IMPORT_MAX_NAME_LENGTH) {
+      failChunk(chunk, line, "vertex name too long", field, 32);
+      return false;
+    }
+    int position = findVertex(graph, field, length);
+    endpoint = position >= 0 ? position
+                             : ~(int64_t) table.intern(field, length, seen);
+    return true;
+  }
+
+  // ID
+  if (length > 0 && field[0] >= 'a' && field[0] <= 'z') {
+    int position = findLabel(graph, field, length);
+    if (position >= 0) {
+      endpoint = position;
+      return true;
+    }
+    failChunk(chunk, line, "undefined identifier", field, length);
+    return false;
+  }
+
+  failChunk(chunk, line, "expected a vertex or identifier, found", field,
+            length);
+  return false;
+}
+//*****************************************************************************
+// Read the lines of a chunk, stopping at the first problem. The source of
+// a line is seen just before its target.
+static void readChunk(ImportChunk *chunk, const Graph *graph,
+                      VertexTable *table, char delimiter)
+{
+  size_t line = chunk->firstLine - 1;
+  const char *eol;
+
+  for (const char *p = chunk->begin; p < chunk->end; p = eol + 1) {
+    line++;
+    eol = (const char *) memchr(p, '\n', chunk->end - p);
+    if (eol == NULL)
+      eol = chunk->end;
+
+    const char *stop = eol;
+    if (stop > p && stop[-1] == '\r')
+      stop--;
+    if (stop == p || *p == '#')
+      continue;
+
+    const char *sourceBegin, *sourceEnd, *targetBegin, *targetEnd;
+    if (!splitFields(p, stop, delimiter, sourceBegin, sourceEnd,
+                     targetBegin, targetEnd)) {
+      failChunk(*chunk, line, "expected a source and a target, found", p,
+                stop - p);
+      return;
+    }
+
+    int64_t source, target;
+    if (!lookup(*graph, *table, sourceBegin, sourceEnd - sourceBegin,
+                (uint64_t) line << 1, *chunk, line, source) ||
+        !lookup(*graph, *table, targetBegin, targetEnd - targetBegin,
+                (uint64_t) line << 1 | 1, *chunk, line, target))
+      return;
+    chunk->endpoints.push_back(source);
+    chunk->endpoints.push_back(target);
+  }
+}
+//*****************************************************************************
+static size_t importParallel(Graph &graph, const string &path, bool directed,
+                             const string &defaultLabel, const MappedFile &file,
+                             char delimiter, size_t threads)
+{
+  const char *end = file.data + file.size;
+  vector<ImportChunk> chunks(threads);
+  vector<thread> workers;
+
+  // Cut after the first newline past each even share of the bytes
+  const char *begin = file.data;
+  for (size_t t = 0; t < threads; t++) {
+    const char *cut = t + 1 == threads ? end
+                                       : file.data + file.size / threads * (t + 1);
+    if (cut < begin)
+      cut = begin;
+    if (cut < end) {
+      const char *eol = (const char *) memchr(cut, '\n', end - cut);
+      cut = eol ? eol + 1 : end;
+    }
+    chunks[t].begin = begin;
+    chunks[t].end = cut;
+    chunks[t].failure.line = 0;
+    begin = cut;
+    workers.push_back(thread(countLines, &chunks[t]));
+  }
+  for (size_t t = 0; t < threads; t++)
+    workers[t].join();
+
+  size_t lines = 0;
+  for (size_t t = 0; t < threads; t++) {
+    chunks[t].firstLine = lines + 1;
+    lines += chunks[t].lines;
+  }
+
+  VertexTable table(file.data, 2 * lines);
+  workers.clear();
+  for (size_t t = 0; t < threads; t++)
+    workers.push_back(thread(readChunk, &chunks[t], &graph, &table, delimiter));
+  for (size_t t = 0; t < threads; t++)
+    workers[t].join();
+
+  // Report the problem a single thread would have met first
+  for (size_t t = 0; t < threads; t++) {
+    const ImportFailure &failure = chunks[t].failure;
+    if (failure.line)
+      fail(path, failure.line, failure.what, failure.field, failure.length);
+  }
+
+  vector<size_t> order = table.order();
+  vector<int> positions(table.capacity());
+  for (size_t i = 0; i < order.size(); i++)
+    positions[order[i]] = addVertex(graph, table.name(order[i]),
+                                    table.length(order[i]), defaultLabel);
+
+  size_t added = 0;
+  for (size_t t = 0; t < threads; t++) {
+    const vector<int64_t> &endpoints = chunks[t].endpoints;
+    for (size_t i = 0; i < endpoints.size(); i += 2) {
+      int source = endpoints[i] >= 0 ? endpoints[i] : positions[~endpoints[i]];
+      int target = endpoints[i + 1] >= 0 ? endpoints[i + 1]
+                                         : positions[~endpoints[i + 1]];
+      addEdge(graph, source, target, directed);
+      added++;
+    }
+  }
+  return added;
+}
+//*****************************************************************************
+// Lines and fields are split straight out of the mapping with memchr, which
+// glibc vectorizes, so a list costs one pass over its bytes and never goes
+// through the scanner.
+size_t importEdgeList(Graph &graph, const string &path, bool directed,
+                      const string &defaultLabel)
+{
+  MappedFile file;
+  mapFile(file, path);
+  if (file.size == 0)
+    return 0;
+
+  const char *p = file.data;
+  const char *end = file.data + file.size;
+
+  // A tab anywhere on the first line makes this a TSV file, otherwise CSV
+  const char *eol = (const char *) memchr(p, '\n', end - p);
+  char delimiter = memchr(p, '\t', (eol ? eol : end) - p) ? '\t' : ',';
+
+  // Large lists are shared between threads
+  size_t threads = thread::hardware_concurrency();
+  if (threads > file.size / IMPORT_BYTES_PER_THREAD)
+    threads = file.size / IMPORT_BYTES_PER_THREAD;
+  if (threads > 1)
+    return importParallel(graph, path, directed, defaultLabel, file,
+                          delimiter, threads);
+
+  size_t line = 0;
+  size_t added = 0;
+
+  while (p < end) {
+    line++;
+    eol = (const char *) memchr(p, '\n', end - p);
+    if (eol == NULL)
+      eol = end;
+
+    const char *stop = eol;
+    if (stop > p && stop[-1] == '\r')
+      stop--;
+
+    if (stop > p && *p != '#') {
+      // Split off the source and target fields
+      const char *sourceBegin, *sourceEnd, *targetBegin, *targetEnd;
+      if (!splitFields(p, stop, delimiter, sourceBegin, sourceEnd,
+                       targetBegin, targetEnd))
+        fail(path, line, "expected a source and a target, found", p, stop - p);
+
+      int source = resolve(graph, sourceBegin, sourceEnd - sourceBegin,
+                           defaultLabel, path, line);
+      int target = resolve(graph, targetBegin, targetEnd - targetBegin,
+                           defaultLabel, path, line);
+      addEdge(graph, source, target, directed);
+      added++;
+    }
+
+    p = eol + 1;
+  }
+
+  return added;
+}
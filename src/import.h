@@ -0,0 +1,31 @@
+//*****************************************************************************
+// Edge language edge list import
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef IMPORT_H
+#define IMPORT_H
+
+#include <string>
+
+#include "graph.h"
+#include "lexer.h"
+
+// Bytes of edge list worth handing to another thread
+#define IMPORT_BYTES_PER_THREAD (1 << 22)
+
+// Longest vertex name a list may hold, however it is read: the longest a
+// program may hold, which also fits the parallel reader's vertex table
+#define IMPORT_MAX_NAME_LENGTH MAX_STRING_LEN
+
+// Add every edge listed in a delimited text file to the graph, returning the
+// number added. Each line holds a source and a target separated by a tab,
+// or by a comma if the first line has no tab; further fields are ignored,
+// as are blank lines and lines starting with #. Endpoints are vertex names
+// or bound labels, as in an edge statement, and names are no longer than
+// IMPORT_MAX_NAME_LENGTH. Large lists are read by several
+// threads, with the same result. Failures throw a message.
+size_t importEdgeList ( Graph &, const std::string &, bool,
+                        const std::string & );
+
+#endif
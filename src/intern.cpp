@@ -0,0 +1,92 @@
+//*****************************************************************************
+// Edge language concurrent vertex table
+// written by Josh Hawkins
+//*****************************************************************************
+#include <string.h>
+#include <algorithm>
+
+#include "intern.h"
+
+using namespace std;
+
+// Orders slots by where their names were first seen
+struct FirstSeen {
+  const vector< atomic<uint64_t> > &first;
+
+  bool operator() (size_t a, size_t b) const
+  {
+    return first[a].load(memory_order_relaxed) <
+           first[b].load(memory_order_relaxed);
+  }
+};
+
+//*****************************************************************************
+// FNV-1a, as the graph uses
+static uint32_t hashName(const char *name, size_t length)
+{
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= (unsigned char) name[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+//*****************************************************************************
+// At least twice as many slots as names, so probes stay short
+VertexTable::VertexTable(const char *base, size_t names) : text(base)
+{
+  size_t size = 16;
+  while (size < 2 * names)
+    size *= 2;
+
+  vector< atomic<uint64_t> > empty(size), never(size);
+  slots.swap(empty);
+  first.swap(never);
+  for (size_t i = 0; i < size; i++) {
+    slots[i].store(0, memory_order_relaxed);
+    first[i].store(UINT64_MAX, memory_order_relaxed);
+  }
+}
+//*****************************************************************************
+size_t VertexTable::intern(const char *name, size_t length, uint64_t seen)
+{
+  uint64_t claim = (uint64_t) (name - text) << 24 | length;
+  size_t mask = slots.size() - 1;
+  size_t i = hashName(name, length) & mask;
+
+  for (;; i = (i + 1) & mask) {
+    uint64_t slot = slots[i].load(memory_order_acquire);
+
+    // Claim an empty slot; if another thread claims it first, it may have
+    // claimed it for this same name
+    if (slot == 0) {
+      if (slots[i].compare_exchange_strong(slot, claim,
+                                           memory_order_acq_rel))
+        break;
+    }
+
+    if ((slot & INTERN_MAX_LENGTH) == length &&
+        memcmp(text + (slot >> 24), name, length) == 0)
+      break;
+  }
+
+  // Keep the earliest point the name was seen at
+  uint64_t earliest = first[i].load(memory_order_relaxed);
+  while (seen < earliest &&
+         !first[i].compare_exchange_weak(earliest, seen,
+                                         memory_order_relaxed))
+    ;
+  return i;
+}
+//*****************************************************************************
+vector<size_t> VertexTable::order() const
+{
+  vector<size_t> used;
+  for (size_t i = 0; i < slots.size(); i++)
+    if (slots[i].load(memory_order_relaxed) != 0)
+      used.push_back(i);
+
+  FirstSeen earlier = { first };
+  sort(used.begin(), used.end(), earlier);
+  return used;
+}
@@ -0,0 +1,61 @@
+//*****************************************************************************
+// Edge language concurrent vertex table
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+// Longest name the table holds; its length shares a slot with its offset
+#define INTERN_MAX_LENGTH ((1u << 24) - 1)
+
+//*****************************************************************************
+// Vertex table
+//
+// Open addressing table of vertex names found in one block of text, which
+// many threads may add to at once without a lock. A slot is claimed by a
+// single compare-and-swap of the name's offset and length, so a name is
+// visible whole or not at all. Each name also keeps the earliest place it
+// was seen, so the names can afterwards be numbered in the order a single
+// thread reading the text would have met them, however the work was split.
+//*****************************************************************************
+class VertexTable
+{
+public:
+  // The text the names are in, and the most names that will be added
+  VertexTable ( const char *, size_t );
+
+  // Find or add the name at the given place in the text, noting that it was
+  // seen at the given point (lower is earlier). Returns its slot.
+  size_t intern ( const char *, size_t, uint64_t );
+
+  // Slots holding names, in the order the names were first seen
+  std::vector<size_t> order ( void ) const;
+
+  const char *name(size_t slot) const
+  {
+    return text + (slots[slot].load(std::memory_order_relaxed) >> 24);
+  }
+
+  size_t length(size_t slot) const
+  {
+    return slots[slot].load(std::memory_order_relaxed) & INTERN_MAX_LENGTH;
+  }
+
+  size_t capacity() const
+  {
+    return slots.size();
+  }
+
+private:
+  const char                         *text;
+  std::vector< std::atomic<uint64_t> > slots;   // offset << 24 | length, or 0
+  std::vector< std::atomic<uint64_t> > first;   // earliest point seen
+};
+
+#endif
@@ -376,8 +376,8 @@ static void yy_fatal_error (yyconst char msg[]  );
 	*yy_cp = '\0'; \
 	(yy_c_buf_p) = yy_cp;
 
-#define YY_NUM_RULES 21
-#define YY_END_OF_BUFFER 22
+#define YY_NUM_RULES 24
+#define YY_END_OF_BUFFER 25
 /* This struct is not used in this scanner,
    but its presence is necessary. */
 struct yy_trans_info
@@ -385,16 +385,14 @@ struct yy_trans_info
 	flex_int32_t yy_verify;
 	flex_int32_t yy_nxt;
 	};
-static yyconst flex_int16_t yy_accept[73] =
+static yyconst flex_int16_t yy_accept[58] =
     {   0,
-       16,   16,   22,   20,   18,   19,   12,   20,   11,   16,
-       17,   17,   17,   17,   17,   17,   17,   17,   13,   18,
-        9,   15,   10,   16,   17,   17,   17,   17,   17,   17,
-       17,   17,   17,   14,   17,   17,   17,    2,   17,   17,
-       17,   17,   17,   17,   17,   17,    3,   17,   17,    1,
-       17,   17,    4,   17,   17,   17,   17,   17,   17,   17,
-       17,   17,   17,    6,   17,   17,    5,    8,   17,   17,
-        7,    0
+        0,    0,    0,    0,    0,    0,   25,   23,   21,   22,
+       23,    8,   23,    7,   19,   20,   20,   20,   20,   20,
+        9,   12,   13,   14,   16,   15,   21,    0,   18,    0,
+        5,   11,    6,   19,   19,   20,   20,   20,   20,   20,
+       10,   12,   14,   17,    0,    0,   20,    2,   20,   20,
+       19,   20,   20,    3,    1,    4,    0
     } ;
 
 static yyconst YY_CHAR yy_ec[256] =
@@ -402,17 +400,17 @@ static yyconst YY_CHAR yy_ec[256] =
         1,    1,    1,    1,    1,    1,    1,    1,    2,    3,
         1,    1,    2,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    2,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    4,    5,    1,    1,    6,    6,    6,
-        6,    6,    6,    6,    6,    6,    6,    7,    1,    1,
-        1,    8,    1,    1,    9,    9,    9,    9,    9,    9,
-        9,    9,    9,    9,    9,    9,    9,    9,    9,    9,
-        9,    9,    9,    9,    9,    9,    9,    9,    9,    9,
-        1,    1,    1,    1,    6,    1,   10,   11,   12,   13,
-
-       14,   15,   16,   17,   18,   19,   19,   20,   19,   21,
-       19,   19,   19,   22,   23,   24,   25,   26,   27,   28,
-       19,   19,    1,   29,    1,    1,    1,    1,    1,    1,
+        1,    2,    1,    4,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    5,    6,    1,    1,    7,    7,    7,
+        7,    7,    7,    7,    7,    7,    7,    8,    1,    1,
+        1,    9,    1,    1,   10,   10,   10,   10,   10,   10,
+       10,   10,   10,   10,   10,   10,   10,   10,   10,   10,
+       10,   10,   10,   10,   10,   10,   10,   10,   10,   10,
+        1,   11,    1,    1,   12,    1,   13,   14,   15,   16,
+
+       17,   18,   19,   15,   20,   15,   15,   21,   15,   22,
+       15,   15,   15,   23,   24,   25,   26,   15,   15,   15,
+       15,   15,    1,   27,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
@@ -429,69 +427,321 @@ static yyconst YY_CHAR yy_ec[256] =
         1,    1,    1,    1,    1
     } ;
 
-static yyconst YY_CHAR yy_meta[30] =
+static yyconst YY_CHAR yy_meta[28] =
     {   0,
-        1,    1,    1,    1,    1,    2,    1,    1,    2,    2,
-        2,    2,    2,    2,    2,    2,    2,    2,    2,    2,
-        2,    2,    2,    2,    2,    2,    2,    2,    1
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1
     } ;
 
-static yyconst flex_uint16_t yy_base[74] =
+static yyconst flex_uint16_t yy_base[58] =
     {   0,
-        0,    0,   84,   85,   81,   85,   85,   22,   75,   72,
-        0,   66,   61,   18,   68,   55,   62,   61,   69,   71,
-       85,   85,   85,   63,    0,   55,   48,   53,   55,   47,
-       41,   43,   46,   85,   45,   48,   47,    0,   37,   45,
-       34,   41,   35,   43,   34,   39,    0,   38,   33,    0,
-       25,   38,    0,   19,   22,   31,   33,   23,   28,   28,
-       26,   28,   24,    0,   16,   24,    0,    0,   20,   13,
-        0,   85,   30
+        1,   29,   57,   85,  113,  141,  169, 1261,  197, 1261,
+      225, 1261,  253,  281,  309,  337,  365,  393,  421,  449,
+      477,  505, 1261,  533, 1261,  561,  589,  617, 1261,  645,
+     1261, 1261, 1261,  673,  701,  729,  757,  785,  813,  841,
+     1261,  869,  897, 1261,  925,  953,  981, 1009, 1037, 1065,
+     1093, 1121, 1149, 1177, 1205, 1233, 1261
     } ;
 
-static yyconst flex_int16_t yy_def[74] =
+static yyconst flex_int16_t yy_def[58] =
     {   0,
-       72,    1,   72,   72,   72,   72,   72,   72,   72,   72,
-       73,   73,   73,   73,   73,   73,   73,   73,   72,   72,
-       72,   72,   72,   72,   73,   73,   73,   73,   73,   73,
-       73,   73,   73,   72,   73,   73,   73,   73,   73,   73,
-       73,   73,   73,   73,   73,   73,   73,   73,   73,   73,
-       73,   73,   73,   73,   73,   73,   73,   73,   73,   73,
-       73,   73,   73,   73,   73,   73,   73,   73,   73,   73,
-       73,    0,   72
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,    0
     } ;
 
-static yyconst flex_uint16_t yy_nxt[115] =
+static yyconst flex_uint16_t yy_nxt[1289] =
     {   0,
-        4,    5,    6,    7,    8,    4,    9,    4,   10,   11,
-       12,   11,   13,   14,   15,   11,   11,   11,   11,   11,
-       11,   11,   11,   16,   11,   17,   18,   11,   19,   21,
-       28,   25,   71,   70,   69,   68,   67,   66,   29,   65,
-       64,   63,   62,   61,   60,   59,   58,   57,   56,   55,
-       22,   54,   53,   52,   51,   50,   49,   48,   47,   46,
-       45,   44,   43,   42,   41,   40,   39,   38,   37,   36,
-       35,   24,   20,   34,   33,   32,   31,   30,   27,   26,
-       24,   23,   20,   72,    3,   72,   72,   72,   72,   72,
-       72,   72,   72,   72,   72,   72,   72,   72,   72,   72,
-
-       72,   72,   72,   72,   72,   72,   72,   72,   72,   72,
-       72,   72,   72,   72
+        7,    8,    9,   10,   11,   12,   13,    8,   14,    8,
+       15,    8,    8,   16,   17,   16,   16,   18,   19,   16,
+       16,   16,   16,   16,   16,   20,   16,   21,    7,    8,
+        9,   10,   11,   12,   13,    8,   14,    8,   15,    8,
+        8,   16,   17,   16,   16,   18,   19,   16,   16,   16,
+       16,   16,   16,   20,   16,   21,    7,   22,   22,   23,
+       22,   22,   22,   22,   22,   22,   22,   22,   22,   22,
+       22,   22,   22,   22,   22,   22,   22,   22,   22,   22,
+       22,   22,   22,   22,    7,   22,   22,   23,   22,   22,
+       22,   22,   22,   22,   22,   22,   22,   22,   22,   22,
+
+       22,   22,   22,   22,   22,   22,   22,   22,   22,   22,
+       22,   22,    7,   24,   24,   25,   24,   24,   26,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+        7,   24,   24,   25,   24,   24,   26,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,    7,   57,   27,   57,
+
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,    7,   28,   28,   57,   29,   28,
+       28,   28,   28,   28,   28,   30,   28,   28,   28,   28,
+       28,   28,   28,   28,   28,   28,   28,   28,   28,   28,
+       28,   28,    7,   57,   57,   57,   57,   57,   57,   57,
+       57,   31,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   32,
+        7,   57,   57,   57,   57,   57,   57,   57,   33,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+
+       57,   57,   57,   57,   57,   57,   57,   57,    7,   57,
+       57,   57,   57,   57,   57,   34,   57,   57,   35,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,    7,   57,   57,   57,
+       57,   57,   57,   36,   57,   57,   36,   57,   36,   36,
+       36,   36,   36,   36,   36,   36,   36,   36,   36,   36,
+       36,   36,   36,   57,    7,   57,   57,   57,   57,   57,
+       57,   36,   57,   57,   36,   57,   36,   36,   36,   36,
+       36,   37,   36,   36,   36,   36,   36,   36,   36,   36,
+       36,   57,    7,   57,   57,   57,   57,   57,   57,   36,
+
+       57,   57,   36,   57,   36,   36,   36,   36,   36,   36,
+       36,   36,   36,   36,   38,   36,   36,   36,   36,   57,
+        7,   57,   57,   57,   57,   57,   57,   36,   57,   57,
+       36,   57,   36,   39,   36,   36,   36,   36,   36,   36,
+       36,   36,   36,   36,   36,   36,   36,   57,    7,   57,
+       57,   57,   57,   57,   57,   36,   57,   57,   36,   57,
+       36,   36,   36,   36,   36,   36,   36,   36,   36,   36,
+       36,   40,   36,   36,   36,   57,    7,   57,   57,   57,
+       57,   57,   41,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+
+       57,   57,   57,   57,    7,   42,   42,   57,   42,   42,
+       42,   42,   42,   42,   42,   42,   42,   42,   42,   42,
+       42,   42,   42,   42,   42,   42,   42,   42,   42,   42,
+       42,   42,    7,   43,   43,   57,   43,   43,   57,   43,
+       43,   43,   43,   43,   43,   43,   43,   43,   43,   43,
+       43,   43,   43,   43,   43,   43,   43,   43,   43,   43,
+        7,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   44,    7,   57,
+       27,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,    7,   28,   28,   57,
+       29,   28,   28,   28,   28,   28,   28,   30,   28,   28,
+       28,   28,   28,   28,   28,   28,   28,   28,   28,   28,
+       28,   28,   28,   28,    7,   45,   45,   57,   45,   45,
+       45,   45,   45,   45,   45,   45,   45,   45,   45,   45,
+       45,   45,   45,   45,   45,   45,   45,   45,   45,   45,
+       45,   45,    7,   57,   57,   57,   57,   57,   57,   34,
+       57,   57,   57,   57,   46,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+
+        7,   57,   57,   57,   57,   57,   57,   34,   57,   57,
+       35,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,    7,   57,
+       57,   57,   57,   57,   57,   36,   57,   57,   36,   57,
+       36,   36,   36,   36,   36,   36,   36,   36,   36,   36,
+       36,   36,   36,   36,   36,   57,    7,   57,   57,   57,
+       57,   57,   57,   36,   57,   57,   36,   57,   36,   36,
+       36,   36,   36,   36,   36,   47,   36,   36,   36,   36,
+       36,   36,   36,   57,    7,   57,   57,   57,   57,   57,
+       57,   36,   57,   57,   36,   57,   36,   36,   36,   36,
+
+       48,   36,   36,   36,   36,   36,   36,   36,   36,   36,
+       36,   57,    7,   57,   57,   57,   57,   57,   57,   36,
+       57,   57,   36,   57,   36,   36,   36,   36,   36,   36,
+       36,   36,   36,   49,   36,   36,   36,   36,   36,   57,
+        7,   57,   57,   57,   57,   57,   57,   36,   57,   57,
+       36,   57,   36,   36,   36,   36,   36,   36,   36,   36,
+       36,   36,   36,   36,   36,   36,   50,   57,    7,   42,
+       42,   57,   42,   42,   42,   42,   42,   42,   42,   42,
+       42,   42,   42,   42,   42,   42,   42,   42,   42,   42,
+       42,   42,   42,   42,   42,   42,    7,   43,   43,   57,
+
+       43,   43,   57,   43,   43,   43,   43,   43,   43,   43,
+       43,   43,   43,   43,   43,   43,   43,   43,   43,   43,
+       43,   43,   43,   43,    7,   28,   28,   57,   29,   28,
+       28,   28,   28,   28,   28,   30,   28,   28,   28,   28,
+       28,   28,   28,   28,   28,   28,   28,   28,   28,   28,
+       28,   28,    7,   57,   57,   57,   57,   57,   57,   51,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+        7,   57,   57,   57,   57,   57,   57,   36,   57,   57,
+       36,   57,   36,   36,   36,   36,   36,   36,   36,   36,
+
+       52,   36,   36,   36,   36,   36,   36,   57,    7,   57,
+       57,   57,   57,   57,   57,   36,   57,   57,   36,   57,
+       36,   36,   36,   36,   36,   36,   36,   36,   36,   36,
+       36,   36,   36,   36,   36,   57,    7,   57,   57,   57,
+       57,   57,   57,   36,   57,   57,   36,   57,   36,   36,
+       36,   36,   36,   36,   36,   36,   36,   36,   36,   36,
+       53,   36,   36,   57,    7,   57,   57,   57,   57,   57,
+       57,   36,   57,   57,   36,   57,   36,   36,   36,   36,
+       36,   54,   36,   36,   36,   36,   36,   36,   36,   36,
+       36,   57,    7,   57,   57,   57,   57,   57,   57,   51,
+
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+        7,   57,   57,   57,   57,   57,   57,   36,   57,   57,
+       36,   57,   36,   36,   36,   36,   36,   36,   36,   36,
+       36,   36,   55,   36,   36,   36,   36,   57,    7,   57,
+       57,   57,   57,   57,   57,   36,   57,   57,   36,   57,
+       36,   36,   36,   36,   36,   56,   36,   36,   36,   36,
+       36,   36,   36,   36,   36,   57,    7,   57,   57,   57,
+       57,   57,   57,   36,   57,   57,   36,   57,   36,   36,
+       36,   36,   36,   36,   36,   36,   36,   36,   36,   36,
+
+       36,   36,   36,   57,    7,   57,   57,   57,   57,   57,
+       57,   36,   57,   57,   36,   57,   36,   36,   36,   36,
+       36,   36,   36,   36,   36,   36,   36,   36,   36,   36,
+       36,   57,    7,   57,   57,   57,   57,   57,   57,   36,
+       57,   57,   36,   57,   36,   36,   36,   36,   36,   36,
+       36,   36,   36,   36,   36,   36,   36,   36,   36,   57,
+        7,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57
     } ;
 
-static yyconst flex_int16_t yy_chk[115] =
+static yyconst flex_int16_t yy_chk[1289] =
     {   0,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    8,
-       14,   73,   70,   69,   66,   65,   63,   62,   14,   61,
-       60,   59,   58,   57,   56,   55,   54,   52,   51,   49,
-        8,   48,   46,   45,   44,   43,   42,   41,   40,   39,
-       37,   36,   35,   33,   32,   31,   30,   29,   28,   27,
-       26,   24,   20,   19,   18,   17,   16,   15,   13,   12,
-       10,    9,    5,    3,   72,   72,   72,   72,   72,   72,
-       72,   72,   72,   72,   72,   72,   72,   72,   72,   72,
-
-       72,   72,   72,   72,   72,   72,   72,   72,   72,   72,
-       72,   72,   72,   72
+        1,    1,    1,    1,    1,    1,    1,    1,    2,    2,
+        2,    2,    2,    2,    2,    2,    2,    2,    2,    2,
+        2,    2,    2,    2,    2,    2,    2,    2,    2,    2,
+        2,    2,    2,    2,    2,    2,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    4,    4,    4,    4,    4,    4,
+        4,    4,    4,    4,    4,    4,    4,    4,    4,    4,
+
+        4,    4,    4,    4,    4,    4,    4,    4,    4,    4,
+        4,    4,    5,    5,    5,    5,    5,    5,    5,    5,
+        5,    5,    5,    5,    5,    5,    5,    5,    5,    5,
+        5,    5,    5,    5,    5,    5,    5,    5,    5,    5,
+        6,    6,    6,    6,    6,    6,    6,    6,    6,    6,
+        6,    6,    6,    6,    6,    6,    6,    6,    6,    6,
+        6,    6,    6,    6,    6,    6,    6,    6,    7,    7,
+        7,    7,    7,    7,    7,    7,    7,    7,    7,    7,
+        7,    7,    7,    7,    7,    7,    7,    7,    7,    7,
+        7,    7,    7,    7,    7,    7,    9,    9,    9,    9,
+
+        9,    9,    9,    9,    9,    9,    9,    9,    9,    9,
+        9,    9,    9,    9,    9,    9,    9,    9,    9,    9,
+        9,    9,    9,    9,   11,   11,   11,   11,   11,   11,
+       11,   11,   11,   11,   11,   11,   11,   11,   11,   11,
+       11,   11,   11,   11,   11,   11,   11,   11,   11,   11,
+       11,   11,   13,   13,   13,   13,   13,   13,   13,   13,
+       13,   13,   13,   13,   13,   13,   13,   13,   13,   13,
+       13,   13,   13,   13,   13,   13,   13,   13,   13,   13,
+       14,   14,   14,   14,   14,   14,   14,   14,   14,   14,
+       14,   14,   14,   14,   14,   14,   14,   14,   14,   14,
+
+       14,   14,   14,   14,   14,   14,   14,   14,   15,   15,
+       15,   15,   15,   15,   15,   15,   15,   15,   15,   15,
+       15,   15,   15,   15,   15,   15,   15,   15,   15,   15,
+       15,   15,   15,   15,   15,   15,   16,   16,   16,   16,
+       16,   16,   16,   16,   16,   16,   16,   16,   16,   16,
+       16,   16,   16,   16,   16,   16,   16,   16,   16,   16,
+       16,   16,   16,   16,   17,   17,   17,   17,   17,   17,
+       17,   17,   17,   17,   17,   17,   17,   17,   17,   17,
+       17,   17,   17,   17,   17,   17,   17,   17,   17,   17,
+       17,   17,   18,   18,   18,   18,   18,   18,   18,   18,
+
+       18,   18,   18,   18,   18,   18,   18,   18,   18,   18,
+       18,   18,   18,   18,   18,   18,   18,   18,   18,   18,
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   19,   19,   19,   19,   19,   19,   20,   20,
+       20,   20,   20,   20,   20,   20,   20,   20,   20,   20,
+       20,   20,   20,   20,   20,   20,   20,   20,   20,   20,
+       20,   20,   20,   20,   20,   20,   21,   21,   21,   21,
+       21,   21,   21,   21,   21,   21,   21,   21,   21,   21,
+       21,   21,   21,   21,   21,   21,   21,   21,   21,   21,
+
+       21,   21,   21,   21,   22,   22,   22,   22,   22,   22,
+       22,   22,   22,   22,   22,   22,   22,   22,   22,   22,
+       22,   22,   22,   22,   22,   22,   22,   22,   22,   22,
+       22,   22,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       26,   26,   26,   26,   26,   26,   26,   26,   26,   26,
+       26,   26,   26,   26,   26,   26,   26,   26,   26,   26,
+       26,   26,   26,   26,   26,   26,   26,   26,   27,   27,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+       27,   27,   27,   27,   27,   27,   28,   28,   28,   28,
+       28,   28,   28,   28,   28,   28,   28,   28,   28,   28,
+       28,   28,   28,   28,   28,   28,   28,   28,   28,   28,
+       28,   28,   28,   28,   30,   30,   30,   30,   30,   30,
+       30,   30,   30,   30,   30,   30,   30,   30,   30,   30,
+       30,   30,   30,   30,   30,   30,   30,   30,   30,   30,
+       30,   30,   34,   34,   34,   34,   34,   34,   34,   34,
+       34,   34,   34,   34,   34,   34,   34,   34,   34,   34,
+       34,   34,   34,   34,   34,   34,   34,   34,   34,   34,
+
+       35,   35,   35,   35,   35,   35,   35,   35,   35,   35,
+       35,   35,   35,   35,   35,   35,   35,   35,   35,   35,
+       35,   35,   35,   35,   35,   35,   35,   35,   36,   36,
+       36,   36,   36,   36,   36,   36,   36,   36,   36,   36,
+       36,   36,   36,   36,   36,   36,   36,   36,   36,   36,
+       36,   36,   36,   36,   36,   36,   37,   37,   37,   37,
+       37,   37,   37,   37,   37,   37,   37,   37,   37,   37,
+       37,   37,   37,   37,   37,   37,   37,   37,   37,   37,
+       37,   37,   37,   37,   38,   38,   38,   38,   38,   38,
+       38,   38,   38,   38,   38,   38,   38,   38,   38,   38,
+
+       38,   38,   38,   38,   38,   38,   38,   38,   38,   38,
+       38,   38,   39,   39,   39,   39,   39,   39,   39,   39,
+       39,   39,   39,   39,   39,   39,   39,   39,   39,   39,
+       39,   39,   39,   39,   39,   39,   39,   39,   39,   39,
+       40,   40,   40,   40,   40,   40,   40,   40,   40,   40,
+       40,   40,   40,   40,   40,   40,   40,   40,   40,   40,
+       40,   40,   40,   40,   40,   40,   40,   40,   42,   42,
+       42,   42,   42,   42,   42,   42,   42,   42,   42,   42,
+       42,   42,   42,   42,   42,   42,   42,   42,   42,   42,
+       42,   42,   42,   42,   42,   42,   43,   43,   43,   43,
+
+       43,   43,   43,   43,   43,   43,   43,   43,   43,   43,
+       43,   43,   43,   43,   43,   43,   43,   43,   43,   43,
+       43,   43,   43,   43,   45,   45,   45,   45,   45,   45,
+       45,   45,   45,   45,   45,   45,   45,   45,   45,   45,
+       45,   45,   45,   45,   45,   45,   45,   45,   45,   45,
+       45,   45,   46,   46,   46,   46,   46,   46,   46,   46,
+       46,   46,   46,   46,   46,   46,   46,   46,   46,   46,
+       46,   46,   46,   46,   46,   46,   46,   46,   46,   46,
+       47,   47,   47,   47,   47,   47,   47,   47,   47,   47,
+       47,   47,   47,   47,   47,   47,   47,   47,   47,   47,
+
+       47,   47,   47,   47,   47,   47,   47,   47,   48,   48,
+       48,   48,   48,   48,   48,   48,   48,   48,   48,   48,
+       48,   48,   48,   48,   48,   48,   48,   48,   48,   48,
+       48,   48,   48,   48,   48,   48,   49,   49,   49,   49,
+       49,   49,   49,   49,   49,   49,   49,   49,   49,   49,
+       49,   49,   49,   49,   49,   49,   49,   49,   49,   49,
+       49,   49,   49,   49,   50,   50,   50,   50,   50,   50,
+       50,   50,   50,   50,   50,   50,   50,   50,   50,   50,
+       50,   50,   50,   50,   50,   50,   50,   50,   50,   50,
+       50,   50,   51,   51,   51,   51,   51,   51,   51,   51,
+
+       51,   51,   51,   51,   51,   51,   51,   51,   51,   51,
+       51,   51,   51,   51,   51,   51,   51,   51,   51,   51,
+       52,   52,   52,   52,   52,   52,   52,   52,   52,   52,
+       52,   52,   52,   52,   52,   52,   52,   52,   52,   52,
+       52,   52,   52,   52,   52,   52,   52,   52,   53,   53,
+       53,   53,   53,   53,   53,   53,   53,   53,   53,   53,
+       53,   53,   53,   53,   53,   53,   53,   53,   53,   53,
+       53,   53,   53,   53,   53,   53,   54,   54,   54,   54,
+       54,   54,   54,   54,   54,   54,   54,   54,   54,   54,
+       54,   54,   54,   54,   54,   54,   54,   54,   54,   54,
+
+       54,   54,   54,   54,   55,   55,   55,   55,   55,   55,
+       55,   55,   55,   55,   55,   55,   55,   55,   55,   55,
+       55,   55,   55,   55,   55,   55,   55,   55,   55,   55,
+       55,   55,   56,   56,   56,   56,   56,   56,   56,   56,
+       56,   56,   56,   56,   56,   56,   56,   56,   56,   56,
+       56,   56,   56,   56,   56,   56,   56,   56,   56,   56,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57
     } ;
 
 static yy_state_type yy_last_accepting_state;
@@ -515,11 +765,66 @@ written by Josh Hawkins
 *******************************************************************/
 #line 7 "rules.l"
 #include "lexer.h"
+#include "reader.h"
+#include "trace.h"
 
 int yyLine = 1;
-#line 521 "lex.yy.c"
+
+/* Take input read ahead by the reader thread when there is one for the
+   file, see reader.h; otherwise read the way flex does by default. Each
+   refill is a span in the trace. */
+#define YY_INPUT(buf,result,max_size) \
+	{ \
+	if ( tracing ) \
+		traceBegin( "refill", "lexer" ); \
+	long ahead = readAhead( yyin, buf, max_size ); \
+	if ( ahead >= 0 ) \
+		result = ahead; \
+	else if ( YY_CURRENT_BUFFER_LVALUE->yy_is_interactive ) \
+		{ \
+		int c = '*'; \
+		size_t n; \
+		for ( n = 0; n < max_size && \
+			     (c = getc( yyin )) != EOF && c != '\n'; ++n ) \
+			buf[n] = (char) c; \
+		if ( c == '\n' ) \
+			buf[n++] = (char) c; \
+		if ( c == EOF && ferror( yyin ) ) \
+			YY_FATAL_ERROR( "input in flex scanner failed" ); \
+		result = n; \
+		} \
+	else \
+		{ \
+		errno=0; \
+		while ( (result = fread(buf, 1, max_size, yyin))==0 && ferror(yyin)) \
+			{ \
+			if( errno != EINTR) \
+				{ \
+				YY_FATAL_ERROR( "input in flex scanner failed" ); \
+				break; \
+				} \
+			errno=0; \
+			clearerr(yyin); \
+			} \
+		} \
+	if ( tracing ) \
+		traceEnd( "refill", "lexer" ); \
+	}
+
+/* Take as much as the scanner's buffer has room for at once */
+#define YY_READ_BUF_SIZE READER_SCAN_SIZE
+
+/* Further classify identifiers and single characters, see below */
+static int yyKeyword(void);
+static int yySymbol(void);
+static int yyNumber(void);
+static int yyRange(void);
+static int yyString(void);
+#line 824 "lex.yy.c"
 
 #define INITIAL 0
+#define LINE_COMMENT 1
+#define BLOCK_COMMENT 2
 
 #ifndef YY_NO_UNISTD_H
 /* Special case for "unistd.h", since it is non-ANSI. We include it way
@@ -735,11 +1040,11 @@ YY_DECL
 		}
 
 	{
-#line 12 "rules.l"
+#line 68 "rules.l"
 
 
  /* Keywords */
-#line 743 "lex.yy.c"
+#line 1048 "lex.yy.c"
 
 	while ( /*CONSTCOND*/1 )		/* loops until end-of-file is reached */
 		{
@@ -766,13 +1071,13 @@ yy_match:
 			while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 				{
 				yy_current_state = (int) yy_def[yy_current_state];
-				if ( yy_current_state >= 73 )
+				if ( yy_current_state >= 58 )
 					yy_c = yy_meta[(unsigned int) yy_c];
 				}
 			yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
 			++yy_cp;
 			}
-		while ( yy_base[yy_current_state] != 85 );
+		while ( yy_base[yy_current_state] != 1261 );
 
 yy_find_action:
 		yy_act = yy_accept[yy_current_state];
@@ -798,122 +1103,143 @@ do_action:	/* This label is used only to access EOF actions. */
 
 case 1:
 YY_RULE_SETUP
-#line 15 "rules.l"
+#line 71 "rules.l"
 { return TOK_BEGIN; }
 	YY_BREAK
 case 2:
 YY_RULE_SETUP
-#line 16 "rules.l"
+#line 72 "rules.l"
 { return TOK_END; }
 	YY_BREAK
 case 3:
 YY_RULE_SETUP
-#line 17 "rules.l"
+#line 73 "rules.l"
 { return TOK_TRUE; }
 	YY_BREAK
 case 4:
 YY_RULE_SETUP
-#line 18 "rules.l"
+#line 74 "rules.l"
 { return TOK_FALSE; }
 	YY_BREAK
-/* Properties */
+/* Punctuation */
 case 5:
 YY_RULE_SETUP
-#line 22 "rules.l"
-{ return TOK_WEIGHTED; }
+#line 78 "rules.l"
+{ return TOK_ARROW; }
 	YY_BREAK
 case 6:
 YY_RULE_SETUP
-#line 23 "rules.l"
-{ return TOK_DIRECTED; }
+#line 79 "rules.l"
+{ return TOK_CUBE; }
 	YY_BREAK
 case 7:
 YY_RULE_SETUP
-#line 24 "rules.l"
-{ return TOK_VERTEX_LABEL; }
+#line 80 "rules.l"
+{ return TOK_COLON; }
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
-#line 25 "rules.l"
-{ return TOK_EDGE_LABEL; }
+#line 81 "rules.l"
+{ return TOK_COMMA; }
 	YY_BREAK
-/* Punctuation */
 case 9:
 YY_RULE_SETUP
-#line 29 "rules.l"
-{ return TOK_ARROW; }
+#line 82 "rules.l"
+{ BEGIN(LINE_COMMENT); return TOK_COMMENT; }
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
-#line 30 "rules.l"
-{ return TOK_CUBE; }
+#line 83 "rules.l"
+{ BEGIN(BLOCK_COMMENT); return TOK_COMMENT_START; }
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
-#line 31 "rules.l"
-{ return TOK_COLON; }
+#line 84 "rules.l"
+{ return TOK_COMMENT_END; }
 	YY_BREAK
+/* The rest of a line comment, and the inside of a block comment */
 case 12:
 YY_RULE_SETUP
-#line 32 "rules.l"
-{ return TOK_COMMA; }
+#line 88 "rules.l"
+
 	YY_BREAK
 case 13:
+/* rule 13 can match eol */
 YY_RULE_SETUP
-#line 33 "rules.l"
-{ return TOK_COMMENT; }
+#line 89 "rules.l"
+{ yyLine++; BEGIN(INITIAL); }
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
-#line 34 "rules.l"
-{ return TOK_COMMENT_START; }
+#line 90 "rules.l"
+
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
-#line 35 "rules.l"
-{ return TOK_COMMENT_END; }
+#line 91 "rules.l"
+
 	YY_BREAK
-/* Abstractions */
 case 16:
+/* rule 16 can match eol */
 YY_RULE_SETUP
-#line 39 "rules.l"
-{ return TOK_VERTEX; }
+#line 92 "rules.l"
+{ yyLine++; }
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
-#line 40 "rules.l"
-{ return TOK_IDENTIFIER; }
+#line 93 "rules.l"
+{ BEGIN(INITIAL); return TOK_COMMENT_END; }
 	YY_BREAK
-/* Eat any whitespace */
+/* A string ends on the line it starts on */
 case 18:
 YY_RULE_SETUP
-#line 44 "rules.l"
+#line 97 "rules.l"
+{ return yyString(); }
+	YY_BREAK
+/* Abstractions. A vertex name may end in a number, and a second
+number after _, as generated vertices are named, e.g. V3 or V2_5. */
+case 19:
+YY_RULE_SETUP
+#line 102 "rules.l"
+{ return TOK_VERTEX; }
+	YY_BREAK
+case 20:
+YY_RULE_SETUP
+#line 103 "rules.l"
+{ return yyKeyword(); }
+	YY_BREAK
+/* Eat any whitespace */
+case 21:
+YY_RULE_SETUP
+#line 107 "rules.l"
 
 	YY_BREAK
 /* Eat newline characters, AND increment line counter */
-case 19:
-/* rule 19 can match eol */
+case 22:
+/* rule 22 can match eol */
 YY_RULE_SETUP
-#line 48 "rules.l"
+#line 111 "rules.l"
 { yyLine++; }
 	YY_BREAK
-/* Found an unknown character */
-case 20:
+/* Found the implicit vertex _, a number, or an unknown character */
+case 23:
 YY_RULE_SETUP
-#line 52 "rules.l"
-{ return TOK_UNKNOWN; }
+#line 115 "rules.l"
+{ return yySymbol(); }
 	YY_BREAK
-/* Recognize end of file */
+/* Recognize end of file, inside a comment or not */
 case YY_STATE_EOF(INITIAL):
-#line 56 "rules.l"
-{ return TOK_EOF; }
+case YY_STATE_EOF(LINE_COMMENT):
+case YY_STATE_EOF(BLOCK_COMMENT):
+#line 119 "rules.l"
+{ BEGIN(INITIAL); return TOK_EOF; }
 	YY_BREAK
-case 21:
+case 24:
 YY_RULE_SETUP
-#line 57 "rules.l"
+#line 121 "rules.l"
 ECHO;
 	YY_BREAK
-#line 917 "lex.yy.c"
+#line 1243 "lex.yy.c"
 
 	case YY_END_OF_BUFFER:
 		{
@@ -1204,7 +1530,7 @@ static int yy_get_next_buffer (void)
 		while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 			{
 			yy_current_state = (int) yy_def[yy_current_state];
-			if ( yy_current_state >= 73 )
+			if ( yy_current_state >= 58 )
 				yy_c = yy_meta[(unsigned int) yy_c];
 			}
 		yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
@@ -1232,11 +1558,11 @@ static int yy_get_next_buffer (void)
 	while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 		{
 		yy_current_state = (int) yy_def[yy_current_state];
-		if ( yy_current_state >= 73 )
+		if ( yy_current_state >= 58 )
 			yy_c = yy_meta[(unsigned int) yy_c];
 		}
 	yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
-	yy_is_jam = (yy_current_state == 72);
+	yy_is_jam = (yy_current_state == 57);
 
 		return yy_is_jam ? 0 : yy_current_state;
 }
@@ -1912,4 +2238,157 @@ void yyfree (void * ptr )
 
 #define YYTABLES_NAME "yytables"
 
-#line 57 "rules.l"
+#line 122 "rules.l"
+
+/*******************************************************************
+Identifiers which are statement keywords. for and the generator
+names are identifiers here; the parser makes keywords of them where
+a statement may start, see parser.cpp.
+*******************************************************************/
+static int yyKeyword(void)
+{
+  if (strcmp(yytext, "import") == 0)
+    return TOK_IMPORT;
+  if (strcmp(yytext, "include") == 0)
+    return TOK_INCLUDE;
+
+  return TOK_IDENTIFIER;
+}
+
+/*******************************************************************
+Single characters: _, the start of a number, generator punctuation,
+or unknown. An opening quote with no closing one is unknown.
+*******************************************************************/
+static int yySymbol(void)
+{
+  if (yytext[0] == '_')
+    return TOK_IMPLICIT;
+  if (yytext[0] == '{')
+    return TOK_OPEN_BRACE;
+  if (yytext[0] == '}')
+    return TOK_CLOSE_BRACE;
+  if (yytext[0] == '(')
+    return TOK_OPEN_PAREN;
+  if (yytext[0] == ')')
+    return TOK_CLOSE_PAREN;
+  if (yytext[0] == '+')
+    return TOK_PLUS;
+  if (yytext[0] == '.')
+    return yyRange();
+  if (yytext[0] == '-' || (yytext[0] >= '0' && yytext[0] <= '9'))
+    return yyNumber();
+
+  return TOK_UNKNOWN;
+}
+
+/*******************************************************************
+A string, quotes and all, is in yytext; its text is left there
+without them. A backslash takes the character after it as it is, so
+\" is a quote and \\ a backslash.
+*******************************************************************/
+static int yyString(void)
+{
+  size_t i, n = 0;
+
+  for (i = 1; i < yyleng - 1; i++) {
+    if (yytext[i] == '\\')
+      i++;
+    yytext[n++] = yytext[i];
+  }
+
+  yytext[n] = '\0';
+  yyleng = n;
+  return TOK_STRING;
+}
+
+/*******************************************************************
+A number: an optional minus sign, digits, and an optional fraction.
+The first character is already in yytext; the number is left there.
+Two points end a number rather than start its fraction, so 1..10 is a
+range, and a minus sign without digits stands on its own.
+*******************************************************************/
+static int yyNumber(void)
+{
+  static char text[MAX_LEXEME_LEN + 1];
+  int c, n = 0, digits = 0, point = 0;
+
+  text[n++] = yytext[0];
+  if (yytext[0] != '-')
+    digits++;
+
+  for (;;) {
+    c = input();
+    if (c >= '0' && c <= '9')
+      digits++;
+    else if (c == '.' && !point) {
+      int next = input();
+      if (next != EOF && next != 0)
+        unput(next);
+      if (next == '.')
+        break;
+      point = 1;
+    } else
+      break;
+
+    if (n == MAX_LEXEME_LEN)
+      return TOK_UNKNOWN;
+    text[n++] = c;
+  }
+
+  /* Give back the character after the number */
+  if (c != EOF && c != 0)
+    unput(c);
+
+  if (digits == 0 && n > 1)
+    return TOK_UNKNOWN;
+
+  text[n] = '\0';
+  yytext = text;
+  yyleng = n;
+  return digits ? TOK_NUMBER : TOK_MINUS;
+}
+
+/*******************************************************************
+The .. of a range; the first point is already in yytext
+*******************************************************************/
+static int yyRange(void)
+{
+  static char text[] = "..";
+  int c = input();
+
+  if (c != '.') {
+    if (c != EOF && c != 0)
+      unput(c);
+    return TOK_UNKNOWN;
+  }
+
+  yytext = text;
+  yyleng = 2;
+  return TOK_RANGE;
+}
+
+/*******************************************************************
+The start condition, set aside while an included module is scanned,
+since the tokens lexed ahead of the include may have been a comment's
+*******************************************************************/
+int yyCondition(void)
+{
+  return YY_START;
+}
+
+void yySetCondition(int condition)
+{
+  BEGIN(condition);
+}
+
+/*******************************************************************
+Whether the input is typed in, so should be lexed no further ahead
+than the parser needs. Before the first token the buffer is yet to
+be made from yyin, which flex takes to be typed in if it is a terminal.
+*******************************************************************/
+int yyInteractive(void)
+{
+  if (YY_CURRENT_BUFFER)
+    return YY_CURRENT_BUFFER->yy_is_interactive;
+  return isatty(fileno(yyin ? yyin : stdin));
+}
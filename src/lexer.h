@@ -9,6 +9,9 @@
 // Maximum lexeme length
 #define MAX_LEXEME_LEN 100
 
+// Maximum string length, e.g. a file name
+#define MAX_STRING_LEN 4096
+
 //*****************************************************************************
 // List of token codes
 //*****************************************************************************
@@ -18,24 +21,32 @@
 #define TOK_END           1001  // end
 #define TOK_TRUE          1002  // true
 #define TOK_FALSE         1003  // false
+#define TOK_IMPORT        1004  // import
+#define TOK_INCLUDE       1005  // include
+#define TOK_FOR           1006  // for, made a keyword by the parser
+#define TOK_GENERATOR     1007  // chain, ring, grid or complete, likewise
 
 // Punctuation
 #define TOK_ARROW         2000  // ->
 #define TOK_CUBE          2001  // ::
 #define TOK_COLON         2002  // :
 #define TOK_COMMA         2003  // ,
+#define TOK_RANGE         2004  // ..
+#define TOK_PLUS          2005  // +
+#define TOK_MINUS         2006  // - on its own
+#define TOK_OPEN_BRACE    2007  // {
+#define TOK_CLOSE_BRACE   2008  // }
+#define TOK_OPEN_PAREN    2009  // (
+#define TOK_CLOSE_PAREN   2013  // )
 #define TOK_COMMENT       2010  // |
 #define TOK_COMMENT_START 2011  // |-
 #define TOK_COMMENT_END   2012  // -|
 
-// Properties
-#define TOK_WEIGHTED      3000  // weighted
-#define TOK_DIRECTED      3001  // directed
-#define TOK_VERTEX_LABEL  3002  // vertexlabel
-#define TOK_EDGE_LABEL    3003  // edgelabel
-
 // Useful abstractions
 #define TOK_IDENTIFIER    4000  // identifier
+#define TOK_IMPLICIT      4001  // _
+#define TOK_STRING        4002  // "string"
+#define TOK_NUMBER        4003  // number, e.g. 2.5
 #define TOK_VERTEX        5000  // vertex
 #define TOK_EOF           6000  // end of file
 #define TOK_UNKNOWN       7000  // unknown lexeme
@@ -0,0 +1,157 @@
+//*****************************************************************************
+// Edge language output files
+// written by Josh Hawkins
+//*****************************************************************************
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <iostream>
+
+#include "output.h"
+
+using namespace std;
+
+// Message thrown when output cannot be written
+static char outputError[1024];
+
+//*****************************************************************************
+OutputFile::OutputFile() : fd(-1)
+{
+}
+//*****************************************************************************
+OutputFile::~OutputFile()
+{
+  if (fd > STDOUT_FILENO)
+    ::close(fd);
+}
+//*****************************************************************************
+// Read and write, so the file can be mapped
+bool OutputFile::open(const string &name)
+{
+  path = name;
+  buffer.clear();
+  if (name == "-") {
+    fd = STDOUT_FILENO;
+    path = "<stdout>";
+  } else
+    fd = ::open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+
+  if (fd >= 0)
+    buffer.reserve(OUTPUT_BUFFER_SIZE);
+  return fd >= 0;
+}
+//*****************************************************************************
+void OutputFile::write(const char *data, size_t length)
+{
+  if (buffer.size() + length < OUTPUT_BUFFER_SIZE) {
+    buffer.append(data, length);
+    return;
+  }
+
+  writeAll(buffer.data(), buffer.size(), data, length);
+  buffer.clear();
+}
+//*****************************************************************************
+void OutputFile::write(const vector<string> &parts)
+{
+  size_t total = 0;
+  for (size_t i = 0; i < parts.size(); i++)
+    total += parts[i].size();
+
+  struct stat info;
+  if (total >= OUTPUT_MAP_MIN && fstat(fd, &info) == 0 &&
+      S_ISREG(info.st_mode)) {
+    writeAll(buffer.data(), buffer.size(), NULL, 0);
+    buffer.clear();
+
+    // The mapping starts at the start of the file, which is page aligned
+    off_t start = lseek(fd, 0, SEEK_CUR);
+    off_t end = start + total;
+    void *map = MAP_FAILED;
+    if (start >= 0 && ftruncate(fd, end) == 0)
+      map = mmap(NULL, end, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    // Without a mapping, as for a file opened only to write, the pieces
+    // are written after all
+    if (map != MAP_FAILED) {
+      char *p = (char *) map + start;
+      for (size_t i = 0; i < parts.size(); i++) {
+        memcpy(p, parts[i].data(), parts[i].size());
+        p += parts[i].size();
+      }
+      munmap(map, end);
+      lseek(fd, end, SEEK_SET);
+      return;
+    }
+  }
+
+  for (size_t i = 0; i < parts.size(); i++)
+    write(parts[i]);
+}
+//*****************************************************************************
+void OutputFile::close()
+{
+  if (fd < 0)
+    return;
+
+  writeAll(buffer.data(), buffer.size(), NULL, 0);
+  string().swap(buffer);
+
+  int closing = fd;
+  fd = -1;
+  if (closing > STDOUT_FILENO && ::close(closing) != 0)
+    fail();
+}
+//*****************************************************************************
+// Write two pieces in one call, then whatever a short write left
+void OutputFile::writeAll(const char *first, size_t firstLength,
+                          const char *second, size_t secondLength)
+{
+  // Anything already printed to the console goes first
+  if (fd == STDOUT_FILENO)
+    cout.flush();
+
+  struct iovec pieces[2];
+  pieces[0].iov_base = (void *) first;
+  pieces[0].iov_len = firstLength;
+  pieces[1].iov_base = (void *) second;
+  pieces[1].iov_len = secondLength;
+
+  struct iovec *piece = pieces;
+  int count = 2;
+  while (count > 0) {
+    if (piece->iov_len == 0) {
+      piece++;
+      count--;
+      continue;
+    }
+
+    ssize_t written = writev(fd, piece, count);
+    if (written < 0 && errno == EINTR)
+      continue;
+    if (written < 0)
+      fail();
+
+    while (count > 0 && (size_t) written >= piece->iov_len) {
+      written -= piece->iov_len;
+      piece++;
+      count--;
+    }
+    if (count > 0) {
+      piece->iov_base = (char *) piece->iov_base + written;
+      piece->iov_len -= written;
+    }
+  }
+}
+//*****************************************************************************
+void OutputFile::fail()
+{
+  snprintf(outputError, sizeof(outputError), "cannot write '%s': %s",
+           path.c_str(), strerror(errno));
+  throw (char const *) outputError;
+}
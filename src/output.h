@@ -0,0 +1,67 @@
+//*****************************************************************************
+// Edge language output files
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+// Output gathered before it is written, so each write is several megabytes
+#define OUTPUT_BUFFER_SIZE (1 << 22)
+
+// Output of a known size at least this large is copied into the file
+// through a mapping rather than written
+#define OUTPUT_MAP_MIN (1 << 24)
+
+//*****************************************************************************
+// Output file
+//
+// Output goes straight to the file descriptor: small pieces are gathered
+// in one buffer, and a piece that fills it is written along with it by a
+// single writev, so nothing is copied twice and there are no per-call
+// stream costs. When every piece is known up front, a regular file is
+// sized once with ftruncate and the pieces copied into a mapping of it.
+// Write errors are thrown as messages.
+//*****************************************************************************
+class OutputFile
+{
+public:
+  OutputFile ();
+  ~OutputFile ();
+
+  // Create or truncate a file, or take standard output for -. Returns
+  // false if the file cannot be created.
+  bool open ( const std::string & );
+
+  bool isOpen() const
+  {
+    return fd >= 0;
+  }
+
+  void write ( const char *, size_t );
+
+  void write(const std::string &text)
+  {
+    write(text.data(), text.size());
+  }
+
+  // Write pieces whose total size is known
+  void write ( const std::vector<std::string> & );
+
+  // Write what is gathered and close the file
+  void close ( void );
+
+private:
+  void writeAll ( const char *, size_t, const char *, size_t );
+  void fail ( void );
+
+  int         fd;
+  std::string path;
+  std::string buffer;   // gathered, not yet written
+};
+
+#endif
@@ -2,85 +2,155 @@
 // Edge language recursive descent parser
 // written by Josh Hawkins
 //*****************************************************************************
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <iostream>
-#include <fstream>
 #include <vector>
 #include <string>
 #include <string.h>
 #include <map>
+#include <set>
+#include <algorithm>
 
 using namespace std;
 
 #include "lexer.h"
-
-extern "C"
-{
-// Instantiate global variables
-extern FILE *yyin;         // input stream
-extern FILE *yyout;        // output stream
-extern int   yyleng;       // length of current lexeme
-extern char *yytext;       // text of current lexeme
-extern int   yylex();      // the generated lexical analyzer
-extern int   yyLine;       // the current source code line
-}
-
-// Production functions
-void P ( void );
-void S ( void );
-void A ( string );
-void E ( string, int );
-void C ( void );
-void M ( void );
-void G ( void );
-void R ( void );
-
-// Function declarations for checking whether the current token is
-// in the first set of each production rule.
-bool IsFirstOfP ( void );
-bool IsFirstOfS ( void );
-bool IsFirstOfA ( void );
-bool IsFirstOfE ( void );
-bool IsFirstOfC ( void );
-bool IsFirstOfM ( void );
-bool IsFirstOfG ( void );
-bool IsFirstOfR ( void );
+#include "graph.h"
+#include "parser.h"
+#include "tokens.h"
+#include "grammar.h"
+#include "emit.h"
+#include "import.h"
+#include "check.h"
+#include "shard.h"
+#include "stats.h"
+#include "reader.h"
+#include "pipeline.h"
+#include "trace.h"
+#include "tree.h"
+#include "output.h"
+#include "session.h"
+#include "generate.h"
+
+// Deepest the parse stack may get. Lists are right recursive, so a long
+// program does not make it any deeper.
+#define PARSE_STACK_SIZE 64
+
+// Matched tokens kept for the semantic actions; all of them are still
+// held by the token stream, so their text is valid
+#define MATCH_HISTORY 4
+static_assert(MATCH_HISTORY <= TOKEN_HISTORY, "matched tokens must stay valid");
+
+// State the semantic actions share while a program is parsed
+struct ParseState {
+  Token    history[MATCH_HISTORY];  // the tokens matched most recently
+  unsigned matched;                 // tokens matched so far
+  int      source;                  // source vertex of the edge being parsed
+
+  // Loop or generator statement being parsed. Its tokens outlast the
+  // history, so the actions copy what they need here as they go.
+  EdgeLoop      loop;
+  GeneratorCall call;
+};
+
+// Semantic actions
+void act ( int, ParseState & );
 
 // Helper functions
-string psp ( int );
-void addNodeToSet( string, string, bool );
-bool doesNodeExist( string );
+int usage ( void );
+const Token &matched ( const ParseState &, unsigned );
+int endpoint ( const Token &, char const * );
+int64_t wholeNumber ( const Token & );
+void setProperty ( const Token &, const Token & );
+void keywordInContext ( void );
+bool memoryReport ( void );
+bool checkReport ( void );
+bool traceReport ( void );
+bool treeReport ( bool );
+string sourcePath ( const string & );
+void openOutput ( const string & );
+const Graph &parseModule ( const string & );
 
 // Needed global variables
-typedef map<string, string> SymbolTableT; // Symbol Table
-int iTok;                                 // The current token
-SymbolTableT SymbolTable;                 // The symbol table
+TokenStream tokens;                       // The tokens lexed ahead
+Graph graph;                              // The parsed vertices and edges
+int parseLine = 1;                        // The line errors are reported on
+
+// Orders vertex positions by vertex name
+struct VertexNameLess {
+  bool operator() (int a, int b) const
+  {
+    return strcmp(vertexName(graph, a), vertexName(graph, b)) < 0;
+  }
+};
 
 // Flags for program behavior
-int JS = 1;
+int OUTPUT = 0;
 int INPUT = 0;
 int PARSE_TREE = 0;
-int DIRECTED = 0;
-
-// JS Output variables
-ofstream jsFile;
-vector<string> nodeLines;
-vector<string> edgeLines;
+int MEM_REPORT = 0;
+int CHECK = 0;
+int WATCH = 0;
+int SHARD = 0;
+int STATS = 0;
+int PIPELINE = 0;
+int BATCH = 0;
+int threads = 0;
+vector<string> batchFiles;
+
+// Output variables
+OutputFile outFile;
+string outFormat = "js";
+string outPath;
+string tracePath;
+string treePath;
+string resumePath;
 string defaultLabel = "_";
 
+// Directory of the input file, which imported files are relative to
+string inputDir;
+string inputPath = "<stdin>";
+
+// Lines and label uses recorded for --check
+CheckLog checkLog;
+
+// The parse tree recorded for -p and --tree
+ParseTree *parseTree = NULL;
+
+// Statements and dependencies recorded for --watch
+vector<StatementMark> *statementLog = NULL;
+set<string> *dependencyLog = NULL;
+
+// Included modules, parsed once each and kept by canonical path
+map<string, Graph> modules;
+vector<string> includeStack;  // files being parsed, outermost first
+char includeError[1024];      // message thrown for errors inside a module
+char propertyError[1024];     // message thrown for an unknown property
+char commandError[1024];      // message thrown for an unknown command
+char outputError[1024];       // message thrown when the output cannot be made
+
+//*****************************************************************************
+// Print how edge is run, returning the status to exit with
+int usage()
+{
+  cout << "Usage: edge [-p][--mem-report][--check][--watch][--shard][--graph-stats][--pipeline][--batch <files>][--threads N][--trace <trace file>][--tree <tree file>][--resume <session file>][-f js|dot|graphml|json][-i <input file>] [-o <output file>]"
+       << endl
+       << "       edge --scaling-check"
+       << endl
+       << "       edge --alloc-check"
+       << endl
+       << "You can exclude input flag to start the Edge REPL."
+       << endl;
+  return 1;
+}
 //*****************************************************************************
 // The main processing loop
 int main (int argc, char* argv[])
 {
   // Ensure we have enough arguments
-  if (argc < 3) {
-    cout << "Usage: edge [-p][-i <input file>] [-o <js output file>]"
-         << endl
-         << "You can exclude input flag to start the Edge REPL."
-         << endl;
-    return 1;
-  }
+  if (argc < 2)
+    return usage();
 
   // Parse arguments
   int i = 1;
@@ -90,28 +160,175 @@ int main (int argc, char* argv[])
       PARSE_TREE = 1;
     }
 
+    // Parse tree as JSON
+    if (strcmp(argv[i], "--tree") == 0 && i + 1 < argc) {
+      treePath = argv[++i];
+    }
+
+    // Memory report
+    if (strcmp(argv[i], "--mem-report") == 0) {
+      MEM_REPORT = 1;
+    }
+
+    // Check only
+    if (strcmp(argv[i], "--check") == 0) {
+      CHECK = 1;
+    }
+
+    // Convert many files at once
+    if (strcmp(argv[i], "--batch") == 0) {
+      BATCH = 1;
+      while (i + 1 < argc && argv[i + 1][0] != '-')
+        batchFiles.push_back(argv[++i]);
+    }
+
+    // Worker threads for --batch
+    if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      threads = atoi(argv[++i]);
+    }
+
+    // Record where the time goes
+    if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+      tracing = 1;
+      tracePath = argv[++i];
+      traceThread("main");
+    }
+
+    // Start from a saved session
+    if (strcmp(argv[i], "--resume") == 0 && i + 1 < argc) {
+      resumePath = argv[++i];
+    }
+
+    // Lex, parse and format on separate threads
+    if (strcmp(argv[i], "--pipeline") == 0) {
+      PIPELINE = 1;
+    }
+
+    // Statistics instead of the graph
+    if (strcmp(argv[i], "--graph-stats") == 0) {
+      STATS = 1;
+    }
+
+    // One output file per group of connected components
+    if (strcmp(argv[i], "--shard") == 0) {
+      SHARD = 1;
+    }
+
+    // Rebuild on every change
+    if (strcmp(argv[i], "--watch") == 0) {
+      WATCH = 1;
+    }
+
     // Input
     if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--input") == 0) {
+      if (i + 1 >= argc)
+        return usage();
       INPUT = 1;
 
-      yyin = fopen(argv[++i], "r");
+      // - is a program piped in, read the same way as a file
+      if (strcmp(argv[++i], "-") == 0) {
+        yyin = stdin;
+      } else {
+        yyin = fopen(argv[i], "r");
+        if (!yyin) {
+          cout << "***ERROR: cannot open '" << argv[i] << "'" << endl;
+          return 1;
+        }
+
+        string input = argv[i];
+        inputPath = input;
+        size_t slash = input.rfind('/');
+        if (slash != string::npos)
+          inputDir = input.substr(0, slash + 1);
+
+        // The input file itself may not be included
+        char *canonical = realpath(argv[i], NULL);
+        if (canonical) {
+          includeStack.push_back(canonical);
+          free(canonical);
+        }
+      }
     }
 
     // Output
     if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--output") == 0) {
-      JS = 1;
-      jsFile.open(argv[++i]);
+      if (i + 1 >= argc)
+        return usage();
+      OUTPUT = 1;
+      outPath = argv[++i];
+    }
+
+    // Output format
+    if (strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--format") == 0) {
+      if (i + 1 >= argc)
+        return usage();
+      outFormat = argv[++i];
+    }
+
+    // Parser scaling check
+    if (strcmp(argv[i], "--scaling-check") == 0) {
+      return scalingCheck();
+    }
 
-      // Prepare JS output file
-      jsFile << "/* Generated by Edge v.0.0.1 */\n"
-             << "(function() {"
-             << "\n  var graph = new Graph2D(document.getElementById('edgecanvas'));"
-             << "\n  graph.setOption('applyGravity', false);";
+    // Output allocation check
+    if (strcmp(argv[i], "--alloc-check") == 0) {
+      return allocationCheck();
     }
 
     ++i;
   }
 
+  // Choose the output backend before doing any work
+  Emitter *emitter = makeEmitter(outFormat);
+  if (emitter == NULL) {
+    cout << "Unknown output format '" << outFormat
+         << "', expected js, dot, graphml or json" << endl;
+    return 1;
+  }
+
+  // A session is a single graph, resumed by a single parse
+  if (!resumePath.empty() && (BATCH || WATCH)) {
+    cout << "--resume cannot be used with --batch or --watch" << endl;
+    delete emitter;
+    return 1;
+  }
+
+  // Every file given to --batch gets its own output file
+  if (BATCH) {
+    delete emitter;
+    int status = runBatch(batchFiles, outFormat, threads);
+    return traceReport() ? status : 1;
+  }
+
+  // Shards go next to a manifest, which needs a name to name them after
+  if (SHARD && (!OUTPUT || outPath == "-")) {
+    cout << "--shard needs an output file" << endl;
+    delete emitter;
+    return 1;
+  }
+
+  // Watching only rebuilds and writes the graph
+  if (WATCH && (CHECK || SHARD || STATS || PIPELINE)) {
+    cout << "--watch cannot be used with --check, --shard, --graph-stats "
+            "or --pipeline" << endl;
+    delete emitter;
+    return 1;
+  }
+
+  // Watching needs files to read and write
+  if (WATCH) {
+    if (!INPUT || yyin == stdin || !OUTPUT || outPath == "-") {
+      cout << "--watch needs both an input and an output file" << endl;
+      delete emitter;
+      return 1;
+    }
+    if (yyin)
+      fclose(yyin);
+    int status = watchInput(inputPath, outPath, emitter);
+    delete emitter;
+    return status;
+  }
+
   // If INPUT not specified, start REPL
   if (!INPUT) {
     yyin = stdin;
@@ -122,492 +339,833 @@ int main (int argc, char* argv[])
          << endl;
   }
 
+  // Start from a saved session, before anything is read
+  if (!resumePath.empty()) {
+    try {
+      loadSession(graph, resumePath);
+    } catch (char const *errmsg) {
+      cout << "***ERROR: " << errmsg << endl;
+      if (INPUT && yyin != stdin)
+        fclose(yyin);
+      delete emitter;
+      return 1;
+    }
+  }
+
   // Prepare parser
-  int token;      // Hold each token code
   yyout = stdout; // Set output stream for flex
-  iTok = yylex(); // Get the first token
 
-  // Begin parsing
-  try {
-    if (!IsFirstOfP())
-      throw "unrecognized symbol at start of program";
+  // Record the parse tree, to be written once parsing is over
+  ParseTree tree;
+  if (PARSE_TREE || !treePath.empty())
+    parseTree = &tree;
 
-    // Process P Production
-    P();
+  // Read the input file ahead while it is being scanned, in large pieces
+  if (INPUT && yyin) {
+    startReader(yyin);
+    yypush_buffer_state(yy_create_buffer(yyin, READER_SCAN_SIZE));
+  }
 
-    if (iTok != TOK_EOF)
-      throw "end of file expected, but there is more here!";
+  // With the pipeline, edges are formatted by a second emitter while
+  // parsing goes on, when the output format allows
+  Emitter *edgeEmitter = NULL;
+  string edgeText;
+  if (PIPELINE && OUTPUT && !SHARD && !STATS && !CHECK)
+    edgeEmitter = makeEmitter(outFormat);
+  if (edgeEmitter && !edgeEmitter->formatsEdgesEarly()) {
+    delete edgeEmitter;
+    edgeEmitter = NULL;
+  }
+
+  // Begin parsing
+  try {
+    if (PIPELINE && INPUT)
+      parsePipelined(edgeEmitter, edgeText);
+    else
+      parseProgram();
   } catch(char const *errmsg) {
-    cout << endl << "***ERROR (line " << yyLine << "): "<< errmsg << endl;
+    treeReport(false);
+    cout << endl << "***ERROR (line " << parseLine << "): "<< errmsg << endl;
 
+    stopReader();
     if (INPUT)
       fclose(yyin);
 
+    delete edgeEmitter;
+    delete emitter;
+    traceReport();
     return 1;
   }
 
   // Close input file
+  stopReader();
   if (INPUT)
     fclose(yyin);
 
-  if (PARSE_TREE) {
-    // Print success
-    cout << endl
-         << "=== Edge parse was successful ==="
-         << endl << endl;
+  if (!treeReport(true)) {
+    delete edgeEmitter;
+    delete emitter;
+    return 1;
+  }
 
-    // Print out the symbol table
-    SymbolTableT::iterator it;
-    for (it = SymbolTable.begin(); it != SymbolTable.end(); ++it) {
-      cout << "Vertex = " << it->first << ", Label = " << it->second << endl;
+  // Report what the checks find instead of writing anything
+  if (CHECK) {
+    delete emitter;
+    bool clean = checkReport();
+    return traceReport() && clean ? 0 : 1;
+  }
+
+  // Write statistics about the graph instead of the graph itself
+  if (STATS) {
+    GraphStats stats = graphStats(graph);
+    try {
+      openOutput(OUTPUT ? outPath : "-");
+      writeStats(stats, outFile);
+      outFile.close();
+    } catch (char const *errmsg) {
+      cout << "***ERROR: " << errmsg << endl;
+      delete emitter;
+      return 1;
     }
+    delete emitter;
+    return traceReport() ? 0 : 1;
+  }
 
-    // TODO: Print out edges
+  // Write the graph with the chosen backend
+  if (OUTPUT) {
+    try {
+      openOutput(outPath);
+      if (SHARD)
+        writeShards(graph, outPath, outFormat, outFile);
+      else if (edgeEmitter)
+        emitter->emit(graph, outFile, edgeText);
+      else
+        emitter->emit(graph, outFile);
+      outFile.close();
+    } catch (char const *errmsg) {
+      cout << "***ERROR: " << errmsg << endl;
+      delete emitter;
+      return 1;
+    }
   }
+  delete edgeEmitter;
+  delete emitter;
 
-  // Write nodes to JS
-  jsFile << "\n\n  /* Create nodes */";
-  for (vector<string>::iterator it = nodeLines.begin(); it != nodeLines.end(); it++)
-    jsFile << *it;
-  // Write edges to JS
-  jsFile << "\n\n  /* Create edges */";
-  for (vector<string>::iterator it = edgeLines.begin(); it != edgeLines.end(); it++)
-    jsFile << *it;
+  // Report memory use, failing if it is over budget
+  if (MEM_REPORT && !memoryReport())
+    return 1;
 
-  // Finalize JS output
-  jsFile << "\n})();";
-  jsFile.close();
+  // Write the trace last, so it covers the output being written
+  if (!traceReport())
+    return 1;
 
   // Return 0 to indicate successful run
   return 0;
 }
 
 //*****************************************************************************
-// P --> {S}
-void P ()
+// The table-driven parser
+//
+// The stack holds the grammar symbols still to be matched, topmost last. A
+// nonterminal is replaced by the production the parse table picks for the
+// current token, a terminal must match the current token, and an action
+// runs on the tokens matched just before it.
+//*****************************************************************************
+void parseProgram()
 {
-  static int Pcnt = 0;
-  int CurPcnt = Pcnt++;
+  int stack[PARSE_STACK_SIZE];
+  int depth = 0;
+  ParseState state;
+
+  state.matched = 0;
+  state.source = -1;
+  stack[depth++] = N_PROGRAM;
+
+  while (depth > 0) {
+    int symbol = stack[--depth];
+
+    // Leaving a nonterminal, marked by its negated index
+    if (symbol < 0) {
+      if (parseTree)
+        parseTree->exit(state.matched ? matched(state, 0).line
+                                      : tokens.peek().line);
+      if (tracing)
+        traceEnd(nonterminals[-1 - symbol].name, "parse");
+      continue;
+    }
+
+    // Actions only need the tokens already matched, so they run before
+    // anything more is read; a statement typed in takes effect at once.
+    // Errors in an action belong to the tokens it works on.
+    if (!isTerminal(symbol) && !isNonterminal(symbol)) {
+      parseLine = matched(state, 0).line;
+      act(symbol, state);
+      continue;
+    }
+
+    const Token &token = tokens.peek();
+    parseLine = token.line;
+
+    if (isTerminal(symbol)) {
+      if (symbol == T_ANY ? token.kind == TOK_EOF
+                          : terminalOf(token.kind) != symbol)
+        throw "unexpected symbol in statement";
+
+      if (parseTree)
+        parseTree->add(TREE_TOKEN, tokens.text(token), token.length, token.line);
+      state.history[state.matched++ % MATCH_HISTORY] = token;
+      tokens.next();
+      continue;
+    }
+
+    if (isNonterminal(symbol)) {
+      if (token.kind == TOK_IDENTIFIER &&
+          (symbol == N_STATEMENT || symbol == N_ASSIGNMENT))
+        keywordInContext();
+
+      int n = symbol - N_PROGRAM;
+      int p = parseTable.entry[n][terminalOf(token.kind)];
+      if (p < 0)
+        throw nonterminals[n].error;
+
+      // Statements only appear at the top level
+      if (symbol == N_STATEMENT && statementLog) {
+        StatementMark statement;
+        statement.line = token.line;
+        statement.mark = markGraph(graph);
+        statementLog->push_back(statement);
+      }
 
-  if (PARSE_TREE)
-    cout << psp(CurPcnt) << "enter P " << CurPcnt << endl;
+      const Production &production = grammar[p];
+      if (depth + production.length + 1 > PARSE_STACK_SIZE)
+        throw "statement is nested too deeply";
+
+      // Lists are flattened in the parse tree and the trace
+      if ((parseTree || tracing) && nonterminals[n].name) {
+        if (parseTree)
+          parseTree->enter(nonterminals[n].name, token.line);
+        if (tracing)
+          traceBegin(nonterminals[n].name, "parse");
+        stack[depth++] = -1 - n;
+      }
+      for (int i = production.length - 1; i >= 0; i--)
+        stack[depth++] = production.rhs[i];
+    }
+  }
+}
+//*****************************************************************************
+void resetParser()
+{
+  graph = Graph();
+  tokens = TokenStream();
+  checkLog = CheckLog();
+  modules.clear();
+  yyLine = 1;
+  yySetCondition(0);
+  parseLine = 1;
+}
+//*****************************************************************************
+void parseFile(const string &path)
+{
+  resetParser();
+  FILE *file = fopen(path.c_str(), "r");
+  if (file == NULL) {
+    snprintf(includeError, sizeof(includeError), "cannot open '%s'",
+             path.c_str());
+    throw (char const *) includeError;
+  }
 
-  // There might be a series of S's
-  while (IsFirstOfS())
-    S();
+  inputPath = path;
+  size_t slash = path.rfind('/');
+  inputDir = slash == string::npos ? "" : path.substr(0, slash + 1);
+  includeStack.assign(1, canonicalPath(path));
+  yypush_buffer_state(yy_create_buffer(file, 16384));
 
-  // Read the next token
-  iTok = yylex();
+  char const *errmsg = NULL;
+  try {
+    parseProgram();
+  } catch (char const *e) {
+    errmsg = e;
+  }
 
-  if (PARSE_TREE)
-    cout << psp(CurPcnt) << "exit P " << CurPcnt << endl;
+  yypop_buffer_state();
+  fclose(file);
+  if (errmsg)
+    throw errmsg;
 }
 
 //*****************************************************************************
-// S --> A | E | C | M | G
-void S ()
+// Semantic actions
+//*****************************************************************************
+void act(int action, ParseState &state)
 {
-  static int Scnt = 0;
-  int CurScnt = Scnt++;
-  string vertex;
-  int lTok;
-  char const *Serr =
-    "statement does not start with 'begin', '|', '|-', or vertex";
-
-  if (PARSE_TREE)
-    cout << psp(CurScnt) << "enter S " << CurScnt << endl;
-
-  // HACK: Set iTok if _ is found
-  if (strcmp(yytext, "_") == 0)
-    iTok = TOK_IDENTIFIER;
-
-  // We know we have found a beginning token, but which?
-  switch (iTok) {
-    case TOK_BEGIN:
-      G();
+  const Token &last = matched(state, 0);
+
+  switch (action) {
+    // E --> ID | VERTEX | _ -> ...
+    case ACT_SOURCE:
+      // The source came just before the arrow
+      state.source = endpoint(matched(state, 1),
+                              "undefined identifier before arrow in edge");
       break;
 
-    case TOK_COMMENT:
-      C();
+    // E --> ... -> (ID | VERTEX | _)
+    case ACT_EDGE: {
+      int target = endpoint(last, "undefined identifier after arrow in edge");
+
+      // Checking goes on past undefined endpoints, leaving the edge out
+      if (state.source < 0 || target < 0)
+        break;
+      addEdge(graph, state.source, target,
+              graph.properties.boolean(PROP_DIRECTED));
+      if (CHECK)
+        logEdges(checkLog, graph, parseLine);
       break;
+    }
 
-    case TOK_COMMENT_START:
-      M();
+    // A --> VERTEX :: [ ID ]
+    case ACT_ASSIGN: {
+      // Without an identifier the label is the default
+      const Token &vertex = matched(state, last.kind == TOK_IDENTIFIER ? 2 : 1);
+      string label = defaultLabel;
+      if (last.kind == TOK_IDENTIFIER)
+        label.assign(tokens.text(last), last.length);
+      else if (parseTree)
+        parseTree->add(TREE_NOTE, "Assuming ID: _", 14, parseLine);
+
+      // Add the vertex to the graph, then label it and bind it to _
+      int position = addVertex(graph, tokens.text(vertex), vertex.length,
+                               defaultLabel);
+      assignLabel(graph, position, label, defaultLabel);
+      if (CHECK)
+        logBinding(checkLog, graph, position, parseLine, label != defaultLabel);
       break;
+    }
 
-    case TOK_IDENTIFIER:
-      // Capture vertex name
-      vertex = yytext;
-      lTok = iTok;
-
-      iTok = yylex();
-      if (iTok == TOK_ARROW)
-        E(vertex, lTok);
-      else
-        throw "edge does not have arrow following vertex or ID";
+    // R --> PROPERTY : true | false | NUMBER | STRING
+    case ACT_PROPERTY:
+      setProperty(matched(state, 2), last);
       break;
 
-    case TOK_VERTEX:
-      // Capture vertex name
-      vertex = yytext;
-      lTok = iTok;
+    // C --> \| { . }
+    case ACT_SKIP_LINE:
+      // Read tokens until end of line
+      while (tokens.peek().line == last.line && tokens.peek().kind != TOK_EOF)
+        tokens.next();
+      break;
 
-      // Determine if this starts an assignment or edge
-      iTok = yylex();
-      if (iTok == TOK_CUBE) {
-        A(vertex);
-      } else {
-        // Must be edge
-        E(vertex, lTok);
+    // M --> \|- { . } -\|
+    case ACT_SKIP_BLOCK:
+      // Read tokens until end of comment found
+      while (tokens.peek().kind != TOK_COMMENT_END) {
+        if (tokens.peek().kind == TOK_EOF)
+          throw "multiline comment is not closed with -|";
+        tokens.next();
       }
+      if (parseTree)
+        parseTree->add(TREE_TOKEN, tokens.text(tokens.peek()),
+                       tokens.peek().length, tokens.peek().line);
+      tokens.next();
       break;
 
-    default:
-      // If we made it to here, syntax error
-      throw Serr;
-  }
+    // I --> import STRING
+    case ACT_IMPORT: {
+      if (dependencyLog)
+        dependencyLog->insert(canonicalPath(sourcePath(tokens.text(last))));
 
-  if (PARSE_TREE)
-    cout << psp(CurScnt) << "exit S " << CurScnt << endl;
-}
+      size_t added = importEdgeList(graph, sourcePath(tokens.text(last)),
+                                    graph.properties.boolean(PROP_DIRECTED),
+                                    defaultLabel);
 
+      // Imported edges may use labels; count them as used
+      if (CHECK) {
+        for (size_t i = graph.edges.size() - added; i < graph.edges.size(); i++) {
+          logUse(checkLog, graph.edges[i].source);
+          logUse(checkLog, graph.edges[i].target);
+        }
+        logEdges(checkLog, graph, parseLine);
+      }
+      if (parseTree) {
+        char note[64];
+        int length = snprintf(note, sizeof(note), "imported %lu edges",
+                              (unsigned long) added);
+        parseTree->add(TREE_NOTE, note, length, parseLine);
+      }
+      break;
+    }
 
-//*****************************************************************************
-// A --> VERTEX :: [ ID ]
-void A (string vertex)
-{
-  static int Acnt = 0;
-  int CurAcnt = Acnt++;
-
-  if (PARSE_TREE)
-    cout << psp(CurAcnt) << "enter A " << CurAcnt << endl;
-
-  // We know we have found :: since we've determined this is assignment
-  if (PARSE_TREE)
-    cout << "-->found " << yytext << endl;
-
-  // Next could be an identifier; save its name
-  iTok = yylex();
-  string IDname = defaultLabel;
-  if (iTok == TOK_IDENTIFIER) {
-    // Capture and print ID
-    IDname = yytext;
-    if (PARSE_TREE)
-      cout << "-->found ID: " << yytext << endl;
-
-    // Read the next token
-    iTok = yylex();
-  } else {
-    if (PARSE_TREE)
-      cout << "-->Assuming ID: _" << endl;
-  }
+    // U --> include STRING
+    case ACT_INCLUDE:
+      // Parse the module on first use, then splice it in. A pipelined
+      // lexer waits for this, as the module is lexed with its globals.
+      spliceGraph(graph, parseModule(sourcePath(tokens.text(last))),
+                  defaultLabel);
+      tokens.resumeLexer();
+      if (CHECK)
+        logEdges(checkLog, graph, parseLine);
+      break;
 
-  // If the identifier is not yet in the symbol table, store it there
-  SymbolTableT::iterator it = SymbolTable.find(vertex);
-  if (it == SymbolTable.end()) {
-    SymbolTable.insert(pair<string, string>(vertex, IDname));
-  }
+    // K --> : (save | load) STRING
+    case ACT_COMMAND: {
+      const Token &command = matched(state, 1);
+      string name(tokens.text(command), command.length);
+      if (name == "save")
+        saveSession(graph, sourcePath(tokens.text(last)));
+      else if (name == "load") {
+        // Formatted edges and check records would refer to the old graph
+        if (PIPELINE || CHECK)
+          throw "sessions cannot be loaded with --pipeline or --check";
+        loadSession(graph, sourcePath(tokens.text(last)));
+      } else {
+        snprintf(commandError, sizeof(commandError),
+                 "unknown command ':%s', expected :save or :load", name.c_str());
+        throw (char const *) commandError;
+      }
+      break;
+    }
 
-  // Update ID in symbol table with value from expression
-  it = SymbolTable.find(vertex);
-  it->second = IDname;
+    // L --> for ID in ...
+    case ACT_LOOP_VARIABLE:
+      if (strcmp(tokens.text(last), "in") != 0)
+        throw "loop variable is not followed by in";
+      state.loop.variable.assign(tokens.text(matched(state, 1)),
+                                 matched(state, 1).length);
+      state.loop.patterns = 0;
+      break;
 
-  // Add the node to our output
-  addNodeToSet(vertex, IDname, true);
+    // L --> ... NUMBER .. NUMBER : ...
+    case ACT_LOOP_RANGE:
+      state.loop.first = wholeNumber(matched(state, 2));
+      state.loop.last = wholeNumber(last);
+      break;
 
-  if (PARSE_TREE)
-    cout << psp(CurAcnt) << "exit A " << CurAcnt << endl;
-}
+    // T --> VERTEX ... | ID | _
+    case ACT_PATTERN: {
+      VertexPattern &pattern = state.loop.patterns++ == 0 ? state.loop.source
+                                                          : state.loop.target;
+      pattern.position = -1;
+      pattern.name.clear();
+      pattern.numbered = false;
+      pattern.offset = 0;
+      if (last.kind == TOK_VERTEX)
+        pattern.name.assign(tokens.text(last), last.length);
+      else
+        pattern.position = endpoint(last, "undefined identifier in loop edge");
+      break;
+    }
 
-//*****************************************************************************
-// E --> ID | VERTEX(, Weight)(, Label) -> (ID | VERTEX)(, Weight)(, Label)
-void E (string identifier, int lTok)
-{
-  static int Ecnt = 0;
-  int CurEcnt = Ecnt++;
-  string vertexSource;
-  string vertexTarget;
-
-  if (PARSE_TREE)
-    cout << psp(CurEcnt) << "enter E " << CurEcnt << endl;
-
-  // Determine if we have an identifier or vertex, and find vertex if appropriate
-  if (lTok == TOK_VERTEX)
-    vertexSource = identifier;
-  else
-    throw "Unidentified symbol before arrow in edge";
-
-  // Print source vertex
-  if (PARSE_TREE)
-    cout << "-->found " << identifier << endl;
-
-  // We have already found an arrow
-  if (PARSE_TREE)
-    cout << "-->found " << yytext << endl;
-
-  // Get next token
-  iTok = yylex();
-  if (iTok != TOK_VERTEX && iTok != TOK_IDENTIFIER)
-    throw "edge target does not begin with vertex or identifier";
-
-  // Determine target vertex
-  if (PARSE_TREE)
-    cout << "-->found " << yytext << endl;
-  if (iTok == TOK_VERTEX)
-    vertexTarget = yytext;
-  else
-    throw "Unidentified symbol after arrow in edge";
-
-  // Create vertices if they do not yet exist
-  addNodeToSet(vertexSource, defaultLabel, false);
-  addNodeToSet(vertexTarget, defaultLabel, false);
-
-  // Write to edgeLines
-  string edge = "\n  graph.linkNodes("
-    + vertexSource
-    + ", "
-    + vertexTarget;
-  if (DIRECTED) {
-    edge = edge + ", { $directedTowards: "
-      + vertexTarget
-      + " }";
-  }
-  edge = edge + ");";
-  edgeLines.push_back(edge);
-
-  // Read next token
-  iTok = yylex();
-
-  if (PARSE_TREE)
-    cout << psp(CurEcnt) << "exit E " << CurEcnt << endl;
-}
+    // T --> VERTEX { ID [+ NUMBER | - NUMBER | NUMBER] }
+    case ACT_OFFSET: {
+      VertexPattern &pattern = state.loop.patterns == 1 ? state.loop.source
+                                                        : state.loop.target;
+      int variable = 0;
+      if (last.kind == TOK_NUMBER) {
+        // A number straight after the variable must carry its minus sign
+        int sign = matched(state, 1).kind;
+        variable = sign == TOK_PLUS || sign == TOK_MINUS ? 2 : 1;
+        if (variable == 1 && tokens.text(last)[0] != '-')
+          throw "vertex index has no + or - before its number";
+        pattern.offset = wholeNumber(last);
+        if (sign == TOK_MINUS)
+          pattern.offset = -pattern.offset;
+      }
 
-//*****************************************************************************
-// C --> \| { . }
-void C ()
-{
-  static int Ccnt = 0;
-  int CurCcnt = Ccnt++;
+      const Token &name = matched(state, variable);
+      if (state.loop.variable.compare(0, string::npos, tokens.text(name),
+                                      name.length) != 0)
+        throw "vertex index is not the loop variable";
+      pattern.numbered = true;
+      break;
+    }
 
-  if (PARSE_TREE)
-    cout << psp(CurCcnt) << "enter C " << CurCcnt << endl;
+    // L --> ... T -> T
+    case ACT_LOOP: {
+      // Checking goes on past undefined endpoints, leaving the edges out
+      const EdgeLoop &loop = state.loop;
+      if ((loop.source.position < 0 && loop.source.name.empty()) ||
+          (loop.target.position < 0 && loop.target.name.empty()))
+        break;
+
+      size_t added = generateLoop(graph, state.loop,
+                                  graph.properties.boolean(PROP_DIRECTED),
+                                  defaultLabel);
+      if (CHECK)
+        logEdges(checkLog, graph, parseLine);
+      if (parseTree) {
+        char note[64];
+        int length = snprintf(note, sizeof(note), "generated %lu edges",
+                              (unsigned long) added);
+        parseTree->add(TREE_NOTE, note, length, parseLine);
+      }
+      break;
+    }
 
-  if (PARSE_TREE)
-    cout << "-->found " << yytext << endl;
+    // W --> GENERATOR ( ...
+    case ACT_GENERATOR:
+      state.call.name.assign(tokens.text(last), last.length);
+      state.call.count = 0;
+      state.call.prefix.clear();
+      break;
 
-  // Read tokens until end of line
-  int currentLine = yyLine;
-  while (yyLine == currentLine)
-    iTok = yylex();
+    // W --> ... NUMBER | VERTEX ...
+    case ACT_ARGUMENT:
+      // A vertex name prefix can only come last
+      if (!state.call.prefix.empty())
+        throw "generator has arguments after its vertex name";
+      if (last.kind == TOK_VERTEX)
+        state.call.prefix.assign(tokens.text(last), last.length);
+      else if (state.call.count == GENERATOR_MAX_ARGUMENTS)
+        throw "generator has too many arguments";
+      else
+        state.call.numbers[state.call.count++] = wholeNumber(last);
+      break;
 
-  if (PARSE_TREE)
-    cout << psp(CurCcnt) << "exit C " << CurCcnt << endl;
+    // W --> ... )
+    case ACT_GENERATE: {
+      size_t added = generateStructure(graph, state.call,
+                                       graph.properties.boolean(PROP_DIRECTED),
+                                       defaultLabel);
+      if (CHECK)
+        logEdges(checkLog, graph, parseLine);
+      if (parseTree) {
+        char note[64];
+        int length = snprintf(note, sizeof(note), "generated %lu edges",
+                              (unsigned long) added);
+        parseTree->add(TREE_NOTE, note, length, parseLine);
+      }
+      break;
+    }
+  }
 }
 
 //*****************************************************************************
-// M --> \|- { . } -\|
-void M ()
+// Helper Functions
+//*****************************************************************************
+const Token &matched(const ParseState &state, unsigned back)
 {
-  static int Mcnt = 0;
-  int CurMcnt = Mcnt++;
-
-  if (PARSE_TREE)
-    cout << "-->found " << yytext << endl;
-
-  if (PARSE_TREE)
-    cout << psp(CurMcnt) << "enter M " << CurMcnt << endl;
-
-  // Read tokens until end of comment found
-  while (iTok != TOK_COMMENT_END)
-    iTok = yylex();
-
-  if (PARSE_TREE)
-    cout << "-->found " << yytext << endl;
-
-
-  // Read next token
-  iTok = yylex();
-
-  if (PARSE_TREE)
-    cout << psp(CurMcnt) << "exit M " << CurMcnt << endl;
+  return state.history[(state.matched - 1 - back) % MATCH_HISTORY];
 }
-
 //*****************************************************************************
-// G --> begin LABEL { R } end
-void G ()
+// for and the generator names are keywords only where a statement may
+// start, and only when followed by what their statement needs: for by its
+// variable and in, a generator by its (. Otherwise they are identifiers
+// like any other, so a vertex may be labeled ring.
+void keywordInContext()
 {
-  static int Gcnt = 0;
-  int CurGcnt = Gcnt++;
-
-  if (PARSE_TREE)
-    cout << psp(CurGcnt) << "enter G " << CurGcnt << endl;
-
-  // We've found 'begin'
-  if (PARSE_TREE)
-    cout << "-->found " << yytext << endl;
-
-  // TODO: Process section label
-  // We expect to find 'config'
-  iTok = yylex();
-  if (PARSE_TREE)
-    cout << "-->found " << yytext << endl;
-
-  // We may see many or no R's
-  iTok = yylex();
-  while (iTok != TOK_END) {
-    if (IsFirstOfR())
-      R();
-    else
-      throw "R does not begin with valid property";
+  const char *word = tokens.text(tokens.peek());
+
+  if (strcmp(word, "for") == 0) {
+    if (tokens.peek(1).kind == TOK_IDENTIFIER &&
+        tokens.peek(2).kind == TOK_IDENTIFIER &&
+        strcmp(tokens.text(tokens.peek(2)), "in") == 0)
+      tokens.retag(TOK_FOR);
+  } else if (strcmp(word, "chain") == 0 || strcmp(word, "ring") == 0 ||
+             strcmp(word, "grid") == 0 || strcmp(word, "complete") == 0) {
+    if (tokens.peek(1).kind == TOK_OPEN_PAREN)
+      tokens.retag(TOK_GENERATOR);
   }
-
-  // Read next token
-  iTok = yylex();
-
-  if (PARSE_TREE)
-    cout << psp(CurGcnt) << "exit G " << CurGcnt << endl;
 }
-
 //*****************************************************************************
-// R --> PROPERTY : true | false
-void R ()
+int endpoint(const Token &token, char const *undefined)
 {
-  static int Rcnt = 0;
-  int CurRcnt = Rcnt++;
-
-  if (PARSE_TREE)
-    cout << psp(CurRcnt) << "enter R " << CurRcnt << endl;
-
-  if (PARSE_TREE)
-    cout << "-->found property " << yytext << endl;
-  string property = yytext;
-
-  // We expect to see :
-  iTok = yylex();
-  if (iTok == TOK_COLON) {
-    if (PARSE_TREE)
-      cout << "-->found " << yytext << endl;
+  int position = -1;
+
+  if (token.kind == TOK_VERTEX) {
+    // Create the vertex if it does not yet exist
+    position = addVertex(graph, tokens.text(token), token.length, defaultLabel);
+  } else if (token.kind == TOK_IDENTIFIER) {
+    position = findLabel(graph, tokens.text(token), token.length);
+    if (position < 0 && !CHECK)
+      throw undefined;
+    if (position < 0)
+      logFinding(checkLog, token.line, string(undefined) + " '" +
+                 tokens.text(token) + "'");
+    else if (CHECK)
+      logUse(checkLog, position);
   } else {
-    throw "did not find : after property";
+    position = graph.current;
+    if (position < 0 && !CHECK)
+      throw "_ used before any vertex assignment";
+    if (position < 0)
+      logFinding(checkLog, token.line, "_ used before any vertex assignment");
   }
 
-  // TODO: Set properties in some table to value
-
-  // Get true or false value
-  iTok = yylex();
-  if (iTok == TOK_TRUE) {
-    if (PARSE_TREE)
-      cout << "-->found TRUE" << endl;
-
-    // Set flags
-    if (strcmp(property.c_str(), "directed") == 0)
-      DIRECTED = 1;
-  } else if (iTok == TOK_FALSE) {
-    if (PARSE_TREE)
-      cout << "-->found FALSE" << endl;
-
-    // Set flags
-    if (strcmp(property.c_str(), "directed") == 0)
-      DIRECTED = 0;
-  } else {
-    throw "property not set to true or false";
-  }
-
-  // Read next token
-  iTok = yylex();
-
-  if (PARSE_TREE)
-    cout << psp(CurRcnt) << "exit R " << CurRcnt << endl;
+  return position;
 }
-
-//*****************************************************************************
-// IsFirstOfX Functions
 //*****************************************************************************
-bool IsFirstOfP()
+// A number given to a loop or generator, which must be whole
+int64_t wholeNumber(const Token &token)
 {
-  return iTok == TOK_VERTEX || iTok == TOK_COMMENT || iTok == TOK_COMMENT_START ||
-    iTok == TOK_BEGIN;
+  const char *text = tokens.text(token);
+  char *end;
+  errno = 0;
+  long long number = strtoll(text, &end, 10);
+  if (*end != '\0' || errno == ERANGE || number > GENERATOR_MAX_NUMBER ||
+      number < -GENERATOR_MAX_NUMBER)
+    throw "loop and generator numbers must be whole numbers, not too large";
+  return number;
 }
 //*****************************************************************************
-bool IsFirstOfS()
+void setProperty(const Token &name, const Token &value)
 {
-  return iTok == TOK_BEGIN || iTok == TOK_IDENTIFIER || iTok == TOK_VERTEX ||
-    iTok == TOK_COMMENT || iTok == TOK_COMMENT_START || strcmp(yytext, "_") == 0;
+  const char *text = tokens.text(value);
+
+  int id = findProperty(tokens.text(name), name.length);
+  if (id < 0) {
+    snprintf(propertyError, sizeof(propertyError),
+             "unknown property '%s'", tokens.text(name));
+    throw (char const *) propertyError;
+  }
+
+  // The value must have the property's type
+  PropertyValue property = graph.properties.values[id];
+  switch (propertyInfo[id].type) {
+    case PROP_BOOL:
+      if (value.kind != TOK_TRUE && value.kind != TOK_FALSE)
+        throw "property not set to true or false";
+      property.boolean = value.kind == TOK_TRUE;
+      break;
+
+    case PROP_NUMBER:
+      if (value.kind != TOK_NUMBER)
+        throw "property not set to a number";
+      property.number = strtod(text, NULL);
+      break;
+
+    case PROP_STRING:
+      if (value.kind != TOK_STRING)
+        throw "property not set to a quoted string";
+      property.text.assign(text, value.length);
+      break;
+  }
+  changeProperty(graph, (PropertyId) id, property);
 }
 //*****************************************************************************
-bool ISFirstOfA()
+bool memoryReport()
 {
-  return iTok == TOK_VERTEX;
+  GraphMemory memory = graphMemory(graph);
+  size_t vertices = graph.vertices.size();
+  size_t edges = graph.edges.size();
+
+  // A vertex owns its record, its name and label, and its index slots
+  double perVertex = vertices ?
+    (double) (memory.vertices + memory.text + memory.indexes) / vertices : 0;
+  double perEdge = edges ? (double) memory.edges / edges : 0;
+
+  cout << endl
+       << "=== Edge memory report ==="
+       << endl << endl
+       << "Vertices = " << vertices << ", Edges = " << edges << endl
+       << "Vertex records = " << memory.vertices << " bytes" << endl
+       << "Edge records = " << memory.edges << " bytes" << endl
+       << "Names and labels = " << memory.text << " bytes" << endl
+       << "Indexes = " << memory.indexes << " bytes" << endl
+       << "Bytes per vertex = " << perVertex
+       << " (budget " << VERTEX_BYTES_BUDGET << ")" << endl
+       << "Bytes per edge = " << perEdge
+       << " (budget " << EDGE_BYTES_BUDGET << ")" << endl;
+
+  if ((vertices >= BUDGET_MIN_COUNT && perVertex > VERTEX_BYTES_BUDGET) ||
+      (edges >= BUDGET_MIN_COUNT && perEdge > EDGE_BYTES_BUDGET)) {
+    cout << endl << "***ERROR: graph memory is over budget" << endl;
+    return false;
+  }
+  return true;
 }
 //*****************************************************************************
-bool IsFirstOfE()
+bool checkReport()
 {
-  return iTok == TOK_IDENTIFIER || iTok == TOK_VERTEX;
+  checkGraph(checkLog, graph);
+
+  for (size_t i = 0; i < checkLog.findings.size(); i++)
+    cout << inputPath << ":" << checkLog.findings[i].line << ": "
+         << checkLog.findings[i].message << endl;
+
+  return checkLog.findings.empty();
 }
 //*****************************************************************************
-bool IsFirstOfC()
+bool traceReport()
 {
-  return iTok == TOK_COMMENT;
+  if (!tracing || writeTrace(tracePath.c_str()))
+    return true;
+
+  cout << "***ERROR: cannot write trace '" << tracePath << "'" << endl;
+  return false;
 }
 //*****************************************************************************
-bool IsFirstOfM()
+// The listing for -p goes to the console in one write, followed by the
+// symbol table by vertex name if the parse succeeded; --tree writes the
+// tree as JSON either way
+bool treeReport(bool parsed)
 {
-  return iTok == TOK_COMMENT_START;
+  if (parseTree == NULL)
+    return true;
+
+  if (PARSE_TREE) {
+    string listing;
+    parseTree->writeText(listing);
+
+    if (parsed) {
+      listing += "\n=== Edge parse was successful ===\n\n";
+
+      vector<int> byName(graph.vertices.size());
+      for (size_t v = 0; v < byName.size(); v++)
+        byName[v] = v;
+      sort(byName.begin(), byName.end(), VertexNameLess());
+
+      for (size_t v = 0; v < byName.size(); v++) {
+        listing += "Vertex = ";
+        listing += vertexName(graph, byName[v]);
+        listing += ", Label = ";
+        listing += vertexLabel(graph, byName[v]);
+        listing += '\n';
+      }
+    }
+    cout.write(listing.data(), listing.size());
+    cout.flush();
+  }
+
+  if (!treePath.empty()) {
+    string json;
+    parseTree->writeJson(json);
+
+    OutputFile out;
+    try {
+      if (!out.open(treePath))
+        throw "cannot write the parse tree";
+      out.write(json);
+      out.close();
+    } catch (char const *errmsg) {
+      cout << "***ERROR: " << errmsg << endl;
+      return false;
+    }
+  }
+  return true;
 }
 //*****************************************************************************
-bool IsFirstOfG()
+void forgetModules()
 {
-  return iTok == TOK_BEGIN;
+  modules.clear();
 }
 //*****************************************************************************
-bool IsFirstOfR()
+string canonicalPath(const string &path)
 {
-  // Assuming all properties are in range 3000-3999
-  return (iTok >= 3000 && iTok < 4000);
+  char *canonical = realpath(path.c_str(), NULL);
+  if (canonical == NULL)
+    return path;
+
+  string result = canonical;
+  free(canonical);
+  return result;
 }
 //*****************************************************************************
-// Helper Functions
-//*****************************************************************************
-string psp(int n)
+string sourcePath(const string &path)
 {
-  string str(n, ' ');
-  return str;
+  // Absolute paths, and paths when reading from the REPL, are used as given
+  if (path.empty() || path[0] == '/')
+    return path;
+  return inputDir + path;
 }
 //*****************************************************************************
-bool doesNodeExist(string vertex)
+// The output is only opened once there is something to write, so a failed
+// parse or a check leaves the last output in place
+void openOutput(const string &path)
 {
-  // Lookup vertex from symbol table
-  SymbolTableT::iterator it;
-  for (it = SymbolTable.begin(); it != SymbolTable.end(); it++) {
-    if (strcmp(it->first.c_str(), vertex.c_str()) == 0)
-      return true;
+  if (!outFile.open(path)) {
+    snprintf(outputError, sizeof(outputError), "cannot write '%s'",
+             path.c_str());
+    throw (char const *) outputError;
   }
-  return false;
 }
 //*****************************************************************************
-void addNodeToSet(string vertex, string label, bool update)
+const Graph &parseModule(const string &path)
 {
-  // Create node string
-  string node = "\n  var "
-    + vertex
-    + " = graph.createNode({renderData: {name: '"
-    + label
-    + "'}});";
-
-  if (doesNodeExist(vertex)) {
-    // If allowed, update
-    if (update) {
-      string prefix = "\n  var " + vertex + " = ";
-      for (vector<string>::iterator linesit = nodeLines.begin(); linesit != nodeLines.end(); linesit++) {
-        string s = *linesit;
-        if (s.find(prefix) == 0) {
-          *linesit = node;
-        }
-      }
+  char *canonical = realpath(path.c_str(), NULL);
+  if (canonical == NULL) {
+    snprintf(includeError, sizeof(includeError),
+             "cannot open module '%s'", path.c_str());
+    throw (char const *) includeError;
+  }
+  string key = canonical;
+  free(canonical);
+
+  if (dependencyLog)
+    dependencyLog->insert(key);
+
+  // Refuse to include a module from inside itself
+  for (size_t i = 0; i < includeStack.size(); i++) {
+    if (includeStack[i] == key) {
+      snprintf(includeError, sizeof(includeError),
+               "include cycle through '%s'", path.c_str());
+      throw (char const *) includeError;
     }
-  } else {
-    // If not found, write to node lines
-    nodeLines.push_back(node);
-    SymbolTable.insert(pair<string, string>(vertex, label));
   }
+
+  map<string, Graph>::iterator cached = modules.find(key);
+  if (cached != modules.end())
+    return cached->second;
+
+  FILE *file = fopen(key.c_str(), "r");
+  if (file == NULL) {
+    snprintf(includeError, sizeof(includeError),
+             "cannot open module '%s'", path.c_str());
+    throw (char const *) includeError;
+  }
+
+  // Set the including file aside and parse the module on its own
+  Graph outer;
+  swap(outer, graph);
+  TokenStream outerTokens;
+  swap(outerTokens, tokens);
+  int outerLine = yyLine;
+  int outerCondition = yyCondition();
+  int outerParseLine = parseLine;
+  int outerCheck = CHECK;
+  vector<StatementMark> *outerStatements = statementLog;
+  string outerDir = inputDir;
+
+  size_t slash = path.rfind('/');
+  inputDir = slash == string::npos ? "" : path.substr(0, slash + 1);
+  yyLine = 1;
+  yySetCondition(0);
+  CHECK = 0;
+  statementLog = NULL;
+  includeStack.push_back(key);
+  yypush_buffer_state(yy_create_buffer(file, 16384));
+
+  char const *errmsg = NULL;
+  try {
+    parseProgram();
+  } catch (char const *e) {
+    errmsg = e;
+  }
+
+  if (errmsg) {
+    // Messages from nested modules already say where they came from
+    if (errmsg != includeError)
+      snprintf(includeError, sizeof(includeError), "in module '%s' (line %d): %s",
+               path.c_str(), parseLine, errmsg);
+  }
+
+  // Return to the including file
+  yypop_buffer_state();
+  fclose(file);
+  includeStack.pop_back();
+  inputDir = outerDir;
+  yyLine = outerLine;
+  yySetCondition(outerCondition);
+  parseLine = outerParseLine;
+  CHECK = outerCheck;
+  statementLog = outerStatements;
+  swap(tokens, outerTokens);
+
+  Graph &module = modules[key];
+  swap(module, graph);
+  swap(graph, outer);
+
+  if (errmsg) {
+    modules.erase(key);
+    throw (char const *) includeError;
+  }
+  return module;
 }
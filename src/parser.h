@@ -0,0 +1,86 @@
+//*****************************************************************************
+// Edge language recursive descent parser
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <stdio.h>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "graph.h"
+#include "emit.h"
+#include "tokens.h"
+
+extern "C"
+{
+// Instantiate global variables
+extern FILE *yyin;         // input stream
+extern FILE *yyout;        // output stream
+extern int   yyLine;       // the current source code line
+
+// Input buffers, so included modules can be scanned in the middle of a file
+typedef struct yy_buffer_state *YY_BUFFER_STATE;
+extern YY_BUFFER_STATE yy_create_buffer( FILE *, int );
+extern YY_BUFFER_STATE yy_scan_bytes( const char *, size_t );
+extern void yy_delete_buffer( YY_BUFFER_STATE );
+extern void yypush_buffer_state( YY_BUFFER_STATE );
+extern void yypop_buffer_state( void );
+
+// Start condition of the scanner; 0 outside comments
+extern int yyCondition( void );
+extern void yySetCondition( int );
+}
+
+// Graph state before a top-level statement, recorded for --watch
+struct StatementMark {
+  int       line;     // line the statement starts on
+  GraphMark mark;
+};
+
+// Parser state
+extern TokenStream tokens;        // The tokens lexed ahead
+extern Graph graph;               // The parsed vertices and edges
+extern int parseLine;             // line errors are reported on
+extern std::string defaultLabel;  // label of vertices not given one
+
+// Where top-level statements, and the files imported or included, are
+// recorded while parsing; NULL when nobody is interested
+extern std::vector<StatementMark> *statementLog;
+extern std::set<std::string> *dependencyLog;
+
+// Parse a whole program from the current input buffer into graph. Errors
+// are thrown as messages, with parseLine set to the offending line.
+void parseProgram ( void );
+
+// Forget the parsed graph and settings so another program can be parsed
+void resetParser ( void );
+
+// Parse a program file into graph, as the input given with -i would be
+void parseFile ( const std::string & );
+
+// Forget the modules parsed so far, so they are read again when included
+void forgetModules ( void );
+
+// Resolve a path to the name modules are kept by, or return it unchanged
+// if it does not exist
+std::string canonicalPath ( const std::string & );
+
+// Rebuild the output whenever the input or a file it uses changes,
+// returning the exit status
+int watchInput ( const std::string &, const std::string &, Emitter * );
+
+// Convert each program file to the given format with the given number of
+// worker threads, returning the exit status
+int runBatch ( const std::vector<std::string> &, const std::string &, int );
+
+// Time the parser on generated programs, returning the exit status
+int scalingCheck ( void );
+
+// Check that writing a graph does not allocate, returning the exit status
+int allocationCheck ( void );
+
+#endif
@@ -0,0 +1,235 @@
+//*****************************************************************************
+// Edge language pipelined parsing
+// written by Josh Hawkins
+//*****************************************************************************
+#include <thread>
+
+#include "pipeline.h"
+#include "parser.h"
+#include "trace.h"
+
+using namespace std;
+
+extern "C"
+{
+extern size_t yyleng;       // length of current lexeme
+extern char  *yytext;       // text of current lexeme
+extern int    yylex();      // the generated lexical analyzer
+}
+
+//*****************************************************************************
+// Edge formatting stage
+//*****************************************************************************
+EdgeFormatter::EdgeFormatter(Emitter *edgeEmitter) :
+  emitter(edgeEmitter), deltas(PIPELINE_QUEUE_SIZE), sentText(0),
+  sentVertices(0), sentEdges(0), stopping(false)
+{
+  for (size_t i = 0; i < deltas.size(); i++)
+    spare.push(&deltas[i]);
+}
+//*****************************************************************************
+void EdgeFormatter::publish(const Graph &graph, bool last)
+{
+  if (!last && graph.edges.size() == sentEdges)
+    return;
+
+  GraphDelta *delta;
+  if (!signal.wait([&] { return spare.pop(delta); }, stopping))
+    return;
+
+  delta->text.assign(graph.text.begin() + sentText, graph.text.end());
+  delta->vertices.assign(graph.vertices.begin() + sentVertices,
+                         graph.vertices.end());
+  delta->edges.assign(graph.edges.begin() + sentEdges, graph.edges.end());
+  delta->last = last;
+  sentText = graph.text.size();
+  sentVertices = graph.vertices.size();
+  sentEdges = graph.edges.size();
+
+  sent.push(delta);
+  signal.notify();
+}
+//*****************************************************************************
+void EdgeFormatter::run()
+{
+  if (tracing)
+    traceThread("formatter");
+
+  for (;;) {
+    GraphDelta *delta;
+    if (!signal.wait([&] { return sent.pop(delta); }, stopping))
+      return;
+
+    copy.text.insert(copy.text.end(), delta->text.begin(), delta->text.end());
+    copy.vertices.insert(copy.vertices.end(), delta->vertices.begin(),
+                         delta->vertices.end());
+    size_t first = copy.edges.size();
+    copy.edges.insert(copy.edges.end(), delta->edges.begin(),
+                      delta->edges.end());
+    if (tracing)
+      traceBegin("format edges", "emit");
+    emitter->formatEdges(copy, first, copy.edges.size(), text);
+    if (tracing)
+      traceEnd("format edges", "emit");
+
+    bool last = delta->last;
+    spare.push(delta);
+    signal.notify();
+    if (last)
+      return;
+  }
+}
+//*****************************************************************************
+void EdgeFormatter::stop()
+{
+  stopping.store(true, memory_order_relaxed);
+  signal.notify();
+}
+
+//*****************************************************************************
+// Lexer stage
+//*****************************************************************************
+TokenPipe::TokenPipe(EdgeFormatter *edgeFormatter) :
+  batches(PIPELINE_QUEUE_SIZE), current(NULL), cursor(0),
+  formatter(edgeFormatter), parked(false), stopping(false)
+{
+  for (size_t i = 0; i < batches.size(); i++)
+    spare.push(&batches[i]);
+}
+//*****************************************************************************
+void TokenPipe::run()
+{
+  bool include = false;     // the last token lexed was include
+
+  if (tracing)
+    traceThread("lexer");
+
+  for (;;) {
+    TokenBatch *batch;
+    if (!signal.wait([&] { return spare.pop(batch); }, stopping))
+      return;
+
+    bool ended = false, park = false;
+    batch->count = 0;
+    batch->text.clear();
+    while (batch->count < PIPELINE_BATCH_TOKENS) {
+      Token &token = batch->tokens[batch->count++];
+      token.kind = yylex();
+      token.line = yyLine;
+      token.offset = batch->text.size();
+      token.length = yyleng;
+      batch->text.insert(batch->text.end(), yytext, yytext + yyleng);
+      batch->text.push_back('\0');
+
+      if (token.kind == TOK_EOF) {
+        ended = true;
+        break;
+      }
+      if (include) {
+        park = true;
+        break;
+      }
+      include = token.kind == TOK_INCLUDE;
+    }
+
+    // Parked before the parser can see the include, so it cannot resume
+    // the lexer first
+    if (park) {
+      include = false;
+      parked.store(true, memory_order_release);
+    }
+    if (!signal.wait([&] { return lexed.push(batch); }, stopping))
+      return;
+    signal.notify();
+    if (ended)
+      return;
+
+    if (park && !signal.wait([&] { return !parked.load(memory_order_acquire); },
+                             stopping))
+      return;
+  }
+}
+//*****************************************************************************
+// Each finished batch goes back to the lexer, and is a point at which the
+// graph parsed so far is sent on to the formatter
+const Token *TokenPipe::take(const char *&text, bool wait)
+{
+  for (;;) {
+    if (current && cursor < current->count) {
+      const Token *token = &current->tokens[cursor++];
+      text = &current->text[token->offset];
+      return token;
+    }
+
+    if (current) {
+      spare.push(current);
+      current = NULL;
+      signal.notify();
+      if (formatter)
+        formatter->publish(graph, false);
+    }
+
+    cursor = 0;
+    if (lexed.pop(current)) {
+      signal.notify();
+      continue;
+    }
+    if (!wait)
+      return NULL;
+    if (!signal.wait([&] { return lexed.pop(current); }, stopping))
+      return NULL;
+    signal.notify();
+  }
+}
+//*****************************************************************************
+// The module has been parsed and flex's globals are the lexer's again
+void TokenPipe::resume()
+{
+  parked.store(false, memory_order_release);
+  signal.notify();
+}
+//*****************************************************************************
+void TokenPipe::stop()
+{
+  stopping.store(true, memory_order_relaxed);
+  signal.notify();
+}
+
+//*****************************************************************************
+void parsePipelined(Emitter *edgeEmitter, string &edgeText)
+{
+  EdgeFormatter *formatter = edgeEmitter && edgeEmitter->formatsEdgesEarly()
+                             ? new EdgeFormatter(edgeEmitter) : NULL;
+  TokenPipe pipe(formatter);
+
+  tokens.readFrom(&pipe);
+  thread lexer(&TokenPipe::run, &pipe);
+  thread formatting;
+  if (formatter)
+    formatting = thread(&EdgeFormatter::run, formatter);
+
+  try {
+    parseProgram();
+  } catch (char const *errmsg) {
+    pipe.stop();
+    lexer.join();
+    if (formatter) {
+      formatter->stop();
+      formatting.join();
+      delete formatter;
+    }
+    tokens.readFrom(NULL);
+    throw;
+  }
+
+  // The parser has reached the end of file, so the lexer has too
+  lexer.join();
+  tokens.readFrom(NULL);
+
+  if (formatter) {
+    formatter->publish(graph, true);
+    formatting.join();
+    edgeText.swap(formatter->text);
+    delete formatter;
+  }
+}
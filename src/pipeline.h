@@ -0,0 +1,179 @@
+//*****************************************************************************
+// Edge language pipelined parsing
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stddef.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "emit.h"
+#include "graph.h"
+#include "spsc.h"
+#include "tokens.h"
+
+// Tokens the lexer stage hands over at a time
+#define PIPELINE_BATCH_TOKENS 4096
+
+// Batches in flight between two stages; a full queue stops the stage
+// feeding it until the next stage catches up. A power of two.
+#define PIPELINE_QUEUE_SIZE   8
+
+// Times a waiting stage yields before it sleeps until another stage wakes it
+#define PIPELINE_SPIN_ROUNDS  64
+
+// Tokens lexed together, their text NUL-terminated at each token's offset
+struct TokenBatch {
+  size_t            count;
+  Token             tokens[PIPELINE_BATCH_TOKENS];
+  std::vector<char> text;
+};
+
+// What the parser added to the graph since the last delta. The text and
+// records are copied in order, so the offsets in them stay valid.
+struct GraphDelta {
+  std::vector<char>   text;
+  std::vector<Vertex> vertices;
+  std::vector<Edge>   edges;
+  bool                last;
+};
+
+//*****************************************************************************
+// Wakeups between two stages
+//
+// A stage with nothing to do yields for a while, since the other stage is
+// usually about to catch up, and then sleeps. Whatever changes what a stage
+// may be waiting for calls notify afterwards; it only takes the lock when
+// someone is asleep.
+//*****************************************************************************
+class StageSignal
+{
+public:
+  StageSignal () : sleepers(0) {}
+
+  // Wait until ready returns true, or return false once stopping is set
+  template <typename Ready>
+  bool wait(Ready ready, const std::atomic<bool> &stopping)
+  {
+    for (int round = 0; round < PIPELINE_SPIN_ROUNDS; round++) {
+      if (ready())
+        return true;
+      if (stopping.load(std::memory_order_relaxed))
+        return false;
+      std::this_thread::yield();
+    }
+
+    std::unique_lock<std::mutex> hold(lock);
+    sleepers.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool done;
+    while (!(done = ready()) && !stopping.load(std::memory_order_relaxed))
+      woken.wait(hold);
+    sleepers.fetch_sub(1);
+    return done;
+  }
+
+  // Wake any stage sleeping in wait
+  void notify()
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers.load() > 0) {
+      std::lock_guard<std::mutex> hold(lock);
+      woken.notify_all();
+    }
+  }
+
+private:
+  std::mutex              lock;
+  std::condition_variable woken;
+  std::atomic<int>        sleepers;
+};
+
+//*****************************************************************************
+// Edge formatting stage
+//
+// Edges never change once parsed, so they are formatted while parsing goes
+// on, against a copy of the graph built from the deltas the parser sends.
+// Vertices are left to the end, since a label can change at any time.
+//*****************************************************************************
+class EdgeFormatter
+{
+public:
+  EdgeFormatter ( Emitter * );
+
+  // Parser side: send what was added to the graph since the last call
+  void publish ( const Graph &, bool );
+
+  // Formatting thread: format edges until the last delta
+  void run ( void );
+
+  // Make either side give up waiting
+  void stop ( void );
+
+  std::string text;     // the formatted edges
+
+private:
+  Emitter                                      *emitter;
+  Graph                                         copy;
+  std::vector<GraphDelta>                       deltas;
+  SpscQueue<GraphDelta *, PIPELINE_QUEUE_SIZE>  sent;
+  SpscQueue<GraphDelta *, PIPELINE_QUEUE_SIZE>  spare;
+  size_t                                        sentText;
+  size_t                                        sentVertices;
+  size_t                                        sentEdges;
+  std::atomic<bool>                             stopping;
+  StageSignal                                   signal;
+};
+
+//*****************************************************************************
+// Lexer stage
+//
+// Flex keeps its state in globals, so only one thread may scan at a time.
+// After an include keyword and the token following it, the lexer parks
+// until the parser has included the module, which is parsed on the
+// parser's thread while the lexer waits.
+//*****************************************************************************
+class TokenPipe
+{
+public:
+  TokenPipe ( EdgeFormatter * );
+
+  // Lexer thread: lex the current input until the end of file
+  void run ( void );
+
+  // Parser side: the next token and its text, or NULL if none is ready
+  // and the caller will not wait for one
+  const Token *take ( const char *&, bool );
+
+  // Parser side: let a parked lexer go on, once an include is done
+  void resume ( void );
+
+  // Make either side give up waiting
+  void stop ( void );
+
+private:
+  std::vector<TokenBatch>                       batches;
+  SpscQueue<TokenBatch *, PIPELINE_QUEUE_SIZE>  lexed;
+  SpscQueue<TokenBatch *, PIPELINE_QUEUE_SIZE>  spare;
+  TokenBatch                                   *current;  // being parsed
+  size_t                                        cursor;   // in current
+  EdgeFormatter                                *formatter;
+  std::atomic<bool>                             parked;
+  std::atomic<bool>                             stopping;
+  StageSignal                                   signal;
+};
+
+// Parse the current input with the lexer, the parser and, given an
+// emitter, edge formatting each on its own thread. The formatted edges are
+// left in the string for Emitter::emit. Errors are thrown as by
+// parseProgram.
+void parsePipelined ( Emitter *, std::string & );
+
+#endif
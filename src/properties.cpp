@@ -0,0 +1,26 @@
+//*****************************************************************************
+// Edge language config properties
+// written by Josh Hawkins
+//*****************************************************************************
+#include <string.h>
+
+#include "properties.h"
+
+//*****************************************************************************
+int findProperty(const char *name, size_t length)
+{
+  int id = propertySlots.id[propertyHash(name, length, propertySeed)];
+  if (id < 0 || strncmp(propertyInfo[id].name, name, length) != 0 ||
+      propertyInfo[id].name[length] != '\0')
+    return -1;
+  return id;
+}
+//*****************************************************************************
+Properties::Properties()
+{
+  for (int id = 0; id < PROPERTY_COUNT; id++) {
+    values[id].boolean = propertyInfo[id].defaultBool;
+    values[id].number = propertyInfo[id].defaultNumber;
+    values[id].text = propertyInfo[id].defaultString;
+  }
+}
@@ -0,0 +1,145 @@
+//*****************************************************************************
+// Edge language config properties
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef PROPERTIES_H
+#define PROPERTIES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+//*****************************************************************************
+// Property registry
+//*****************************************************************************
+
+// Types a property value can have
+enum PropertyType {
+  PROP_BOOL,        // true or false
+  PROP_NUMBER,      // e.g. 2.5
+  PROP_STRING       // e.g. "Pipeline"
+};
+
+// Properties, in registry order
+enum PropertyId {
+  PROP_WEIGHTED,
+  PROP_DIRECTED,
+  PROP_VERTEX_LABEL,
+  PROP_EDGE_LABEL,
+  PROP_TITLE,
+  PROPERTY_COUNT
+};
+
+struct PropertyInfo {
+  const char  *name;            // name used in a config section
+  PropertyType type;
+  bool         defaultBool;
+  double       defaultNumber;
+  const char  *defaultString;
+};
+
+constexpr PropertyInfo propertyInfo[PROPERTY_COUNT] = {
+  { "weighted",    PROP_BOOL,   false, 0, "" },
+  { "directed",    PROP_BOOL,   false, 0, "" },
+  { "vertexlabel", PROP_BOOL,   false, 0, "" },
+  { "edgelabel",   PROP_BOOL,   false, 0, "" },
+  { "title",       PROP_STRING, false, 0, "" },   // caption of the graph
+};
+
+//*****************************************************************************
+// Perfect hash of property names
+//
+// The compiler searches for an FNV-1a seed that sends every property name
+// to its own slot, so a lookup is one hash and one comparison.
+//*****************************************************************************
+
+// Slots in the hash table, a power of two at least PROPERTY_COUNT
+#define PROPERTY_SLOTS 8
+
+constexpr uint32_t propertyHash(const char *name, size_t length, uint32_t seed)
+{
+  uint32_t hash = seed;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= (unsigned char) name[i];
+    hash *= 16777619u;
+  }
+  return hash & (PROPERTY_SLOTS - 1);
+}
+
+constexpr size_t propertyNameLength(int id)
+{
+  size_t length = 0;
+  while (propertyInfo[id].name[length])
+    length++;
+  return length;
+}
+
+constexpr bool isPerfectSeed(uint32_t seed)
+{
+  bool used[PROPERTY_SLOTS] = {};
+  for (int id = 0; id < PROPERTY_COUNT; id++) {
+    uint32_t slot = propertyHash(propertyInfo[id].name, propertyNameLength(id), seed);
+    if (used[slot])
+      return false;
+    used[slot] = true;
+  }
+  return true;
+}
+
+constexpr uint32_t findPerfectSeed()
+{
+  uint32_t seed = 2166136261u;
+  while (!isPerfectSeed(seed))
+    seed++;
+  return seed;
+}
+
+constexpr uint32_t propertySeed = findPerfectSeed();
+
+// Property in each slot, or -1
+struct PropertySlots {
+  signed char id[PROPERTY_SLOTS];
+};
+
+constexpr PropertySlots buildPropertySlots()
+{
+  PropertySlots slots = {};
+  for (int i = 0; i < PROPERTY_SLOTS; i++)
+    slots.id[i] = -1;
+  for (int id = 0; id < PROPERTY_COUNT; id++)
+    slots.id[propertyHash(propertyInfo[id].name, propertyNameLength(id),
+                          propertySeed)] = id;
+  return slots;
+}
+
+constexpr PropertySlots propertySlots = buildPropertySlots();
+
+static_assert(PROPERTY_COUNT <= PROPERTY_SLOTS, "too many properties");
+
+// Find a property by name, or -1 if there is no such property
+int findProperty ( const char *, size_t );
+
+//*****************************************************************************
+// Property values
+//*****************************************************************************
+
+// One property's value; only the member for its type is used
+struct PropertyValue {
+  bool        boolean;
+  double      number;
+  std::string text;
+};
+
+// The config of a graph, every property starting at its default
+struct Properties {
+  PropertyValue values[PROPERTY_COUNT];
+
+  Properties ();
+
+  bool boolean(PropertyId id) const { return values[id].boolean; }
+  double number(PropertyId id) const { return values[id].number; }
+  const std::string &text(PropertyId id) const { return values[id].text; }
+};
+
+#endif
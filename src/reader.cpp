@@ -0,0 +1,183 @@
+//*****************************************************************************
+// Edge language input read ahead on another thread
+// written by Josh Hawkins
+//*****************************************************************************
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "reader.h"
+#include "trace.h"
+
+using namespace std;
+
+// One of the reader's buffers. The reader thread owns it while it is not
+// full, and the scanner owns it from when it is full until it hands it back.
+struct ReadBuffer {
+  vector<char> data;
+  size_t       length;    // bytes read into it
+  size_t       used;      // bytes copied out of it
+  bool         full;
+  bool         last;      // the file ends after it
+  int          error;     // errno of a read that failed after it, or 0
+};
+
+// The reader shared by the scanner and the reader thread
+static struct Reader {
+  FILE                   *file;
+  int                     fd;
+  bool                    running;
+  bool                    stopping;
+  ReadBuffer              buffers[2];
+  int                     current;    // buffer the scanner reads next
+  bool                    holding;    // the scanner holds the current buffer
+  mutex                   lock;
+  condition_variable      changed;
+  thread                  worker;
+} reader;
+
+//*****************************************************************************
+// Fill a buffer, returning the bytes read; fewer than asked means the file
+// has ended, or could not be read any further and error is set. Only an
+// interrupted read is tried again.
+static size_t fill(int fd, char *data, size_t size, int &error)
+{
+  size_t done = 0;
+  error = 0;
+  while (done < size) {
+    ssize_t got = read(fd, data + done, size - done);
+    if (got < 0 && errno == EINTR)
+      continue;
+    if (got < 0)
+      error = errno;
+    if (got <= 0)
+      break;
+    done += got;
+  }
+  return done;
+}
+//*****************************************************************************
+// The reader thread fills the buffers in turn, waiting whenever the next
+// one is still held by the scanner
+static void readLoop()
+{
+  if (tracing)
+    traceThread("reader");
+
+  for (int b = 0; ; b ^= 1) {
+    ReadBuffer &buffer = reader.buffers[b];
+    {
+      unique_lock<mutex> hold(reader.lock);
+      reader.changed.wait(hold, [&buffer] {
+        return !buffer.full || reader.stopping;
+      });
+      if (reader.stopping)
+        return;
+    }
+
+    if (tracing)
+      traceBegin("read", "reader");
+    int error;
+    size_t length = fill(reader.fd, buffer.data.data(), buffer.data.size(),
+                         error);
+    if (tracing)
+      traceEnd("read", "reader");
+    {
+      lock_guard<mutex> hold(reader.lock);
+      buffer.length = length;
+      buffer.used = 0;
+      buffer.last = length < buffer.data.size();
+      buffer.error = error;
+      buffer.full = true;
+    }
+    reader.changed.notify_all();
+
+    if (buffer.last)
+      return;
+  }
+}
+//*****************************************************************************
+void startReader(FILE *file)
+{
+  reader.file = file;
+  reader.fd = fileno(file);
+  reader.stopping = false;
+  reader.current = 0;
+  reader.holding = false;
+  for (int b = 0; b < 2; b++) {
+    reader.buffers[b].data.resize(READER_BUFFER_SIZE);
+    reader.buffers[b].full = false;
+  }
+
+  reader.worker = thread(readLoop);
+  reader.running = true;
+}
+//*****************************************************************************
+void stopReader()
+{
+  if (!reader.running)
+    return;
+
+  {
+    lock_guard<mutex> hold(reader.lock);
+    reader.stopping = true;
+  }
+  reader.changed.notify_all();
+  reader.worker.join();
+
+  reader.running = false;
+  reader.file = NULL;
+  for (int b = 0; b < 2; b++)
+    vector<char>().swap(reader.buffers[b].data);
+}
+//*****************************************************************************
+// The scanner holds the last buffer once it has taken everything before
+// the end of the file
+int readError()
+{
+  if (!reader.running || !reader.holding)
+    return 0;
+  const ReadBuffer &buffer = reader.buffers[reader.current];
+  return buffer.last ? buffer.error : 0;
+}
+//*****************************************************************************
+// Called by the scanner through YY_INPUT. The lock is only taken to swap
+// buffers, once per READER_BUFFER_SIZE bytes.
+long readAhead(FILE *file, char *buf, size_t size)
+{
+  if (!reader.running || file != reader.file)
+    return -1;
+
+  ReadBuffer *buffer = &reader.buffers[reader.current];
+  if (reader.holding && buffer->used == buffer->length) {
+    if (buffer->last)
+      return 0;
+
+    {
+      lock_guard<mutex> hold(reader.lock);
+      buffer->full = false;
+      reader.holding = false;
+    }
+    reader.changed.notify_all();
+
+    reader.current ^= 1;
+    buffer = &reader.buffers[reader.current];
+  }
+
+  if (!reader.holding) {
+    unique_lock<mutex> hold(reader.lock);
+    reader.changed.wait(hold, [buffer] { return buffer->full; });
+    reader.holding = true;
+  }
+
+  size_t n = buffer->length - buffer->used;
+  if (n > size)
+    n = size;
+  memcpy(buf, buffer->data.data() + buffer->used, n);
+  buffer->used += n;
+  return n;
+}
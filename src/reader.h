@@ -0,0 +1,44 @@
+//*****************************************************************************
+// Edge language input read ahead on another thread
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef READER_H
+#define READER_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+// Size of each of the two buffers the reader fills in turn
+#define READER_BUFFER_SIZE (1 << 20)
+
+// Size of the scanner's own buffer for input read ahead, and the most it
+// takes from the reader at a time
+#define READER_SCAN_SIZE (1 << 18)
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Start reading a file ahead on another thread. The scanner must not have
+// read from it yet.
+void startReader ( FILE * );
+
+// Stop the reader thread, dropping anything it read ahead
+void stopReader ( void );
+
+// Copy up to the given number of bytes read ahead from a file, returning
+// how many were copied, 0 at the end of the file, or -1 if the file is not
+// being read ahead. A read error ends the file early.
+long readAhead ( FILE *, char *, size_t );
+
+// The errno of the read error that ended the file early, once the scanner
+// has reached that end, or 0
+int readError ( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
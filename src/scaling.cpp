@@ -0,0 +1,178 @@
+//*****************************************************************************
+// Edge language parser scaling check
+// written by Josh Hawkins
+//*****************************************************************************
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "parser.h"
+
+using namespace std;
+
+// Statements in each generated program
+static const size_t scalingSizes[] = { 10000, 100000, 1000000 };
+#define SCALING_SIZE_COUNT (sizeof(scalingSizes) / sizeof(scalingSizes[0]))
+
+// Times each program is parsed; the fastest run is kept
+#define SCALING_RUNS 3
+
+// Highest growth exponent allowed. n log n fits about 1.09 over these
+// sizes and n^2 fits 2, so this leaves room for timing noise only.
+#define SCALING_MAX_EXPONENT 1.25
+
+// Kinds of statement the generated programs are made of
+enum StatementKind {
+  KIND_EDGE,
+  KIND_ASSIGNMENT,
+  KIND_RELABEL,
+  KIND_COMMENT,
+  KIND_CONFIG,
+  KIND_COUNT
+};
+
+static const char *kindNames[KIND_COUNT] = {
+  "edges", "assignments", "relabels", "comments", "config blocks"
+};
+
+// Vertices the relabel programs keep relabeling
+#define RELABEL_VERTICES 1000
+
+//*****************************************************************************
+// Append the vertex name for a number: A, B, ..., Z, AA, AB, ...
+static void appendVertexName(string &out, size_t n)
+{
+  char name[16];
+  int length = 0;
+
+  do {
+    name[length++] = 'A' + n % 26;
+    n = n / 26;
+  } while (n-- > 0);
+
+  while (length > 0)
+    out += name[--length];
+}
+//*****************************************************************************
+static void generate(StatementKind kind, size_t statements, string &out)
+{
+  char label[32];
+
+  out.clear();
+  for (size_t i = 0; i < statements; i++) {
+    switch (kind) {
+      case KIND_EDGE:
+        appendVertexName(out, i);
+        out += " -> ";
+        appendVertexName(out, i + 1);
+        out += '\n';
+        break;
+
+      case KIND_ASSIGNMENT:
+        snprintf(label, sizeof(label), " :: v%lu\n", (unsigned long) i);
+        appendVertexName(out, i);
+        out += label;
+        break;
+
+      case KIND_RELABEL:
+        snprintf(label, sizeof(label), " :: v%lu\n", (unsigned long) i);
+        appendVertexName(out, i % RELABEL_VERTICES);
+        out += label;
+        break;
+
+      case KIND_COMMENT:
+        out += "| comment line\n";
+        break;
+
+      case KIND_CONFIG:
+        out += i % 2 ? "begin config\ndirected: false\nend\n"
+                     : "begin config\ndirected: true\nend\n";
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+//*****************************************************************************
+// Parse a program from memory, returning the seconds taken
+static double timeParse(const string &program)
+{
+  resetParser();
+  YY_BUFFER_STATE buffer = yy_scan_bytes(program.data(), program.size());
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  parseProgram();
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+  yy_delete_buffer(buffer);
+  return elapsed.count();
+}
+//*****************************************************************************
+// Least squares slope of log(time) against log(size)
+static double growthExponent(const double *seconds)
+{
+  double sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+
+  for (size_t i = 0; i < SCALING_SIZE_COUNT; i++) {
+    double x = log((double) scalingSizes[i]);
+    double y = log(seconds[i] > 1e-9 ? seconds[i] : 1e-9);
+    sumX += x;
+    sumY += y;
+    sumXX += x * x;
+    sumXY += x * y;
+  }
+
+  double n = SCALING_SIZE_COUNT;
+  return (n * sumXY - sumX * sumY) / (n * sumXX - sumX * sumX);
+}
+//*****************************************************************************
+// Each statement kind is parsed at every size, and the growth of its parse
+// time is fitted as a power of the size. Any kind growing faster than
+// n log n (plus noise) fails the check.
+int scalingCheck()
+{
+  string program;
+  bool passed = true;
+
+  cout << "=== Edge parser scaling check ===" << endl << endl;
+
+  for (int kind = 0; kind < KIND_COUNT; kind++) {
+    double seconds[SCALING_SIZE_COUNT];
+
+    for (size_t i = 0; i < SCALING_SIZE_COUNT; i++) {
+      generate((StatementKind) kind, scalingSizes[i], program);
+
+      try {
+        seconds[i] = timeParse(program);
+        for (int run = 1; run < SCALING_RUNS; run++) {
+          double again = timeParse(program);
+          if (again < seconds[i])
+            seconds[i] = again;
+        }
+      } catch (char const *errmsg) {
+        cout << "***ERROR (" << kindNames[kind] << ", line " << parseLine
+             << "): " << errmsg << endl;
+        return 1;
+      }
+    }
+
+    double exponent = growthExponent(seconds);
+    bool ok = exponent <= SCALING_MAX_EXPONENT;
+    passed = passed && ok;
+
+    printf("%-14s", kindNames[kind]);
+    for (size_t i = 0; i < SCALING_SIZE_COUNT; i++)
+      printf("  %7lu: %8.4fs", (unsigned long) scalingSizes[i], seconds[i]);
+    printf("  n^%.2f %s\n", exponent, ok ? "ok" : "TOO SLOW");
+  }
+  resetParser();
+
+  if (!passed) {
+    cout << endl << "***ERROR: parse time grows faster than n log n" << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,134 @@
+//*****************************************************************************
+// Edge language work-stealing task scheduler
+// written by Josh Hawkins
+//*****************************************************************************
+#include "scheduler.h"
+#include "trace.h"
+
+using namespace std;
+
+// The worker each thread is, or -1
+static thread_local int workerIndex = -1;
+
+//*****************************************************************************
+Scheduler::Scheduler(size_t count) : pending(0), dealt(0), stopping(false)
+{
+  if (count == 0)
+    count = 1;
+  start = chrono::steady_clock::now();
+
+  for (size_t i = 0; i < count; i++) {
+    workers.push_back(new Worker());
+    workers[i]->stats.tasks = workers[i]->stats.stolen = 0;
+    workers[i]->stats.busy = 0;
+  }
+  for (size_t i = 0; i < count; i++)
+    workers[i]->thread = thread(&Scheduler::run, this, i);
+}
+//*****************************************************************************
+Scheduler::~Scheduler()
+{
+  wait();
+  stopping.store(true, memory_order_relaxed);
+  // Workers still look in each other's deques until all have stopped
+  for (size_t i = 0; i < workers.size(); i++)
+    workers[i]->thread.join();
+  for (size_t i = 0; i < workers.size(); i++)
+    delete workers[i];
+}
+//*****************************************************************************
+void Scheduler::spawn(const Task &task)
+{
+  int self = workerIndex;
+  size_t i = self >= 0 ? self : dealt.fetch_add(1) % workers.size();
+
+  pending.fetch_add(1);
+  lock_guard<mutex> hold(workers[i]->lock);
+  workers[i]->tasks.push_back(task);
+}
+//*****************************************************************************
+void Scheduler::wait()
+{
+  while (pending.load() != 0)
+    this_thread::sleep_for(chrono::microseconds(SCHEDULER_NAP_US));
+}
+//*****************************************************************************
+vector<WorkerStats> Scheduler::stats() const
+{
+  vector<WorkerStats> all;
+  for (size_t i = 0; i < workers.size(); i++)
+    all.push_back(workers[i]->stats);
+  return all;
+}
+//*****************************************************************************
+double Scheduler::elapsed() const
+{
+  chrono::duration<double> seconds = chrono::steady_clock::now() - start;
+  return seconds.count();
+}
+//*****************************************************************************
+int Scheduler::current()
+{
+  return workerIndex;
+}
+//*****************************************************************************
+// Take the newest task of worker i, or else steal the oldest task of the
+// first other worker that has one
+bool Scheduler::take(size_t i, Task &task, bool &stolen)
+{
+  {
+    lock_guard<mutex> hold(workers[i]->lock);
+    if (!workers[i]->tasks.empty()) {
+      task.swap(workers[i]->tasks.back());
+      workers[i]->tasks.pop_back();
+      stolen = false;
+      return true;
+    }
+  }
+
+  for (size_t k = 1; k < workers.size(); k++) {
+    Worker *victim = workers[(i + k) % workers.size()];
+    lock_guard<mutex> hold(victim->lock);
+    if (!victim->tasks.empty()) {
+      task.swap(victim->tasks.front());
+      victim->tasks.pop_front();
+      stolen = true;
+      return true;
+    }
+  }
+  return false;
+}
+//*****************************************************************************
+void Scheduler::run(size_t i)
+{
+  WorkerStats &stats = workers[i]->stats;
+  size_t idle = 0;
+  workerIndex = i;
+  if (tracing)
+    traceThread("worker");
+
+  for (;;) {
+    Task task;
+    bool stolen;
+
+    if (take(i, task, stolen)) {
+      chrono::steady_clock::time_point began = chrono::steady_clock::now();
+      task();
+      chrono::duration<double> spent = chrono::steady_clock::now() - began;
+
+      stats.tasks++;
+      stats.stolen += stolen;
+      stats.busy += spent.count();
+      pending.fetch_sub(1);
+      idle = 0;
+      continue;
+    }
+
+    if (stopping.load(memory_order_relaxed))
+      return;
+    if (++idle < SCHEDULER_SPINS)
+      this_thread::yield();
+    else
+      this_thread::sleep_for(chrono::microseconds(SCHEDULER_NAP_US));
+  }
+}
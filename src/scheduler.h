@@ -0,0 +1,86 @@
+//*****************************************************************************
+// Edge language work-stealing task scheduler
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stddef.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Failed attempts to find a task before an idle worker starts sleeping
+// between attempts
+#define SCHEDULER_SPINS 64
+
+// How long an idle worker sleeps between attempts, in microseconds
+#define SCHEDULER_NAP_US 50
+
+typedef std::function<void ()> Task;
+
+// What one worker did, for the utilization report
+struct WorkerStats {
+  size_t tasks;       // tasks run
+  size_t stolen;      // of those, taken from another worker
+  double busy;        // seconds spent running tasks
+};
+
+//*****************************************************************************
+// Scheduler
+//
+// Each worker has its own deque of tasks. A worker runs its newest task
+// first, so a task it has just spawned is usually still warm in its cache;
+// a worker with nothing left steals the oldest task of another, which
+// tends to be the biggest piece of work left. Tasks spawned from outside
+// the workers are dealt out in turn.
+//*****************************************************************************
+class Scheduler
+{
+public:
+  Scheduler ( size_t );
+  ~Scheduler ();
+
+  // Queue a task; it may spawn further tasks
+  void spawn ( const Task & );
+
+  // Return once every task spawned so far, and every task they spawned,
+  // has run
+  void wait ( void );
+
+  size_t size() const
+  {
+    return workers.size();
+  }
+
+  // What each worker has done, and the seconds since the scheduler started
+  std::vector<WorkerStats> stats ( void ) const;
+  double elapsed ( void ) const;
+
+  // The worker running the calling thread, or -1 outside the workers
+  static int current ( void );
+
+private:
+  struct Worker {
+    std::mutex       lock;
+    std::deque<Task> tasks;
+    std::thread      thread;
+    WorkerStats      stats;
+  };
+
+  void run ( size_t );
+  bool take ( size_t, Task &, bool & );
+
+  std::vector<Worker *>                 workers;
+  std::atomic<size_t>                   pending;    // spawned, not yet run
+  std::atomic<size_t>                   dealt;      // outside spawns so far
+  std::atomic<bool>                     stopping;
+  std::chrono::steady_clock::time_point start;
+};
+
+#endif
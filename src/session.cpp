@@ -0,0 +1,279 @@
+//*****************************************************************************
+// Edge language saved sessions
+// written by Josh Hawkins
+//*****************************************************************************
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "session.h"
+#include "output.h"
+
+using namespace std;
+
+// Message thrown when a session cannot be saved or loaded
+static char sessionError[1024];
+
+//*****************************************************************************
+static uint64_t aligned(uint64_t offset)
+{
+  return (offset + 7) & ~(uint64_t) 7;
+}
+//*****************************************************************************
+static void fail(const char *what, const string &path)
+{
+  snprintf(sessionError, sizeof(sessionError), "%s '%s'", what, path.c_str());
+  throw (char const *) sessionError;
+}
+//*****************************************************************************
+void saveSession(const Graph &graph, const string &path)
+{
+  SessionHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, SESSION_MAGIC, sizeof(header.magic));
+  header.version = SESSION_VERSION;
+  header.propertyCount = PROPERTY_COUNT;
+  header.current = graph.current;
+  header.directedEdges = graph.directedEdges;
+  header.namesUsed = graph.names.used;
+  header.labelsUsed = graph.labels.used;
+  header.stringsUsed = graph.strings.used;
+
+  SessionProperty properties[PROPERTY_COUNT];
+  string propertyText;
+  for (int i = 0; i < PROPERTY_COUNT; i++) {
+    const PropertyValue &value = graph.properties.values[i];
+    properties[i].number = value.number;
+    properties[i].boolean = value.boolean;
+    properties[i].textLength = value.text.size();
+    propertyText += value.text;
+  }
+
+  vector<SessionStructure> structures(graph.structures.size());
+  for (size_t i = 0; i < structures.size(); i++) {
+    const Structure &structure = graph.structures[i];
+    structures[i].kind = structure.kind;
+    structures[i].firstVertex = structure.firstVertex;
+    structures[i].vertices = structure.vertices;
+    structures[i].width = structure.width;
+    structures[i].firstEdge = structure.firstEdge;
+    structures[i].edges = structure.edges;
+    structures[i].directed = structure.directed;
+    structures[i].unused = 0;
+  }
+
+  const void *data[SECTION_COUNT] = {
+    graph.vertices.data(), graph.edges.data(), graph.text.data(),
+    graph.names.slots.data(), graph.labels.slots.data(),
+    graph.strings.slots.data(), properties, propertyText.data(),
+    structures.data()
+  };
+  header.length[SECTION_VERTICES] = graph.vertices.size() * sizeof(Vertex);
+  header.length[SECTION_EDGES] = graph.edges.size() * sizeof(Edge);
+  header.length[SECTION_TEXT] = graph.text.size();
+  header.length[SECTION_NAMES] = graph.names.slots.size() * sizeof(uint32_t);
+  header.length[SECTION_LABELS] = graph.labels.slots.size() * sizeof(uint32_t);
+  header.length[SECTION_STRINGS] = graph.strings.slots.size() * sizeof(uint32_t);
+  header.length[SECTION_PROPERTIES] = sizeof(properties);
+  header.length[SECTION_PROPERTY_TEXT] = propertyText.size();
+  header.length[SECTION_STRUCTURES] = structures.size() * sizeof(SessionStructure);
+
+  uint64_t offset = aligned(sizeof(header));
+  for (int s = 0; s < SECTION_COUNT; s++) {
+    header.offset[s] = offset;
+    offset = aligned(offset + header.length[s]);
+  }
+  header.size = offset;
+
+  OutputFile out;
+  if (!out.open(path))
+    fail("cannot write session", path);
+
+  static const char padding[8] = { 0 };
+  out.write((const char *) &header, sizeof(header));
+  out.write(padding, aligned(sizeof(header)) - sizeof(header));
+  for (int s = 0; s < SECTION_COUNT; s++) {
+    out.write((const char *) data[s], header.length[s]);
+    out.write(padding, aligned(header.length[s]) - header.length[s]);
+  }
+  out.close();
+}
+//*****************************************************************************
+// Edges a structure of its kind and size has, or -1 for an unknown kind
+static int64_t shapeEdges(const SessionStructure &s)
+{
+  int64_t n = s.vertices;
+  switch (s.kind) {
+    case STRUCTURE_CHAIN:
+      return n > 0 ? n - 1 : 0;
+    case STRUCTURE_RING:
+      return n;
+    case STRUCTURE_GRID: {
+      if (s.width == 0 || n % s.width != 0)
+        return -1;
+      int64_t width = s.width, height = n / width;
+      return (width - 1) * height + width * (height - 1);
+    }
+    case STRUCTURE_COMPLETE:
+      return n * (n - 1) / 2;
+  }
+  return -1;
+}
+//*****************************************************************************
+// Check that the records of a mapped session only refer to what is there
+static bool consistent(const SessionHeader &header, const char *base)
+{
+  for (int s = 0; s < SECTION_COUNT; s++)
+    if (header.offset[s] % 8 != 0 || header.offset[s] > header.size ||
+        header.length[s] > header.size - header.offset[s])
+      return false;
+
+  uint64_t vertices = header.length[SECTION_VERTICES] / sizeof(Vertex);
+  uint64_t edges = header.length[SECTION_EDGES] / sizeof(Edge);
+  uint64_t text = header.length[SECTION_TEXT];
+  if (header.length[SECTION_VERTICES] % sizeof(Vertex) != 0 ||
+      header.length[SECTION_EDGES] % sizeof(Edge) != 0 ||
+      header.length[SECTION_STRUCTURES] % sizeof(SessionStructure) != 0 ||
+      header.length[SECTION_PROPERTIES] != PROPERTY_COUNT * sizeof(SessionProperty) ||
+      vertices > MAX_VERTICES || header.current < -1 ||
+      header.current >= (int64_t) vertices || header.directedEdges < 0 ||
+      (uint64_t) header.directedEdges > edges ||
+      (text > 0 && base[header.offset[SECTION_TEXT] + text - 1] != '\0'))
+    return false;
+
+  // Hash tables are powers of two, as probing masks with their size, and
+  // at most half full, as probing stops at an empty slot. Used slots hold
+  // a vertex position, or for strings a text offset, plus 2.
+  const uint64_t used[] = {
+    header.namesUsed, header.labelsUsed, header.stringsUsed
+  };
+  for (int s = SECTION_NAMES; s <= SECTION_STRINGS; s++) {
+    uint64_t slots = header.length[s] / sizeof(uint32_t);
+    if (header.length[s] % sizeof(uint32_t) != 0 || (slots & (slots - 1)) != 0)
+      return false;
+
+    const uint32_t *slot = (const uint32_t *) (base + header.offset[s]);
+    uint64_t limit = s == SECTION_STRINGS ? text : vertices;
+    uint64_t filled = 0;
+    for (uint64_t i = 0; i < slots; i++) {
+      if (slot[i] != 0)
+        filled++;
+      if (slot[i] >= 2 && slot[i] - 2 >= limit)
+        return false;
+    }
+    if (filled != used[s - SECTION_NAMES] || filled * 2 > slots)
+      return false;
+  }
+
+  const Vertex *vertex = (const Vertex *) (base + header.offset[SECTION_VERTICES]);
+  for (uint64_t i = 0; i < vertices; i++)
+    if (vertex[i].name >= text || vertex[i].label >= text)
+      return false;
+
+  const Edge *edge = (const Edge *) (base + header.offset[SECTION_EDGES]);
+  for (uint64_t i = 0; i < edges; i++)
+    if (edge[i].source >= vertices || edge[i].target >= vertices)
+      return false;
+
+  // Structures lie within the records and have as many edges as their
+  // shape, so writing them costs no more than writing their edges
+  const SessionStructure *structure =
+    (const SessionStructure *) (base + header.offset[SECTION_STRUCTURES]);
+  uint64_t structures = header.length[SECTION_STRUCTURES] / sizeof(SessionStructure);
+  for (uint64_t i = 0; i < structures; i++) {
+    const SessionStructure &s = structure[i];
+    if ((uint64_t) s.firstVertex + s.vertices > vertices ||
+        (uint64_t) s.firstEdge + s.edges > edges || s.directed > 1 ||
+        shapeEdges(s) != (int64_t) s.edges)
+      return false;
+  }
+
+  const SessionProperty *property =
+    (const SessionProperty *) (base + header.offset[SECTION_PROPERTIES]);
+  uint64_t propertyText = 0;
+  for (int i = 0; i < PROPERTY_COUNT; i++)
+    propertyText += property[i].textLength;
+  return propertyText == header.length[SECTION_PROPERTY_TEXT];
+}
+//*****************************************************************************
+// Copy the records of a section into a vector
+template <class T>
+static void copySection(vector<T> &records, const SessionHeader &header,
+                        const char *base, SessionSection section)
+{
+  const T *first = (const T *) (base + header.offset[section]);
+  records.assign(first, first + header.length[section] / sizeof(T));
+}
+//*****************************************************************************
+void loadSession(Graph &graph, const string &path)
+{
+  // Rolling back across a load would mix two graphs
+  if (graph.journaling)
+    fail("cannot load a session while watching, from", path);
+
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    fail("cannot open session", path);
+
+  struct stat info;
+  void *map = MAP_FAILED;
+  if (fstat(fd, &info) == 0 && (size_t) info.st_size >= sizeof(SessionHeader))
+    map = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+    fail("not a session file:", path);
+
+  const char *base = (const char *) map;
+  const SessionHeader &header = *(const SessionHeader *) base;
+  if (memcmp(header.magic, SESSION_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != SESSION_VERSION ||
+      header.propertyCount != PROPERTY_COUNT ||
+      header.size != (uint64_t) info.st_size || !consistent(header, base)) {
+    munmap(map, info.st_size);
+    fail("not a session file, or a damaged one:", path);
+  }
+
+  Graph loaded;
+  copySection(loaded.vertices, header, base, SECTION_VERTICES);
+  copySection(loaded.edges, header, base, SECTION_EDGES);
+  copySection(loaded.text, header, base, SECTION_TEXT);
+  copySection(loaded.names.slots, header, base, SECTION_NAMES);
+  copySection(loaded.labels.slots, header, base, SECTION_LABELS);
+  copySection(loaded.strings.slots, header, base, SECTION_STRINGS);
+  loaded.names.used = header.namesUsed;
+  loaded.labels.used = header.labelsUsed;
+  loaded.strings.used = header.stringsUsed;
+  const SessionStructure *structure =
+    (const SessionStructure *) (base + header.offset[SECTION_STRUCTURES]);
+  loaded.structures.resize(header.length[SECTION_STRUCTURES] /
+                           sizeof(SessionStructure));
+  for (size_t i = 0; i < loaded.structures.size(); i++) {
+    Structure &s = loaded.structures[i];
+    s.kind = structure[i].kind;
+    s.firstVertex = structure[i].firstVertex;
+    s.vertices = structure[i].vertices;
+    s.width = structure[i].width;
+    s.firstEdge = structure[i].firstEdge;
+    s.edges = structure[i].edges;
+    s.directed = structure[i].directed != 0;
+  }
+  loaded.current = header.current;
+  loaded.directedEdges = header.directedEdges;
+
+  const SessionProperty *property =
+    (const SessionProperty *) (base + header.offset[SECTION_PROPERTIES]);
+  const char *text = base + header.offset[SECTION_PROPERTY_TEXT];
+  for (int i = 0; i < PROPERTY_COUNT; i++) {
+    PropertyValue &value = loaded.properties.values[i];
+    value.number = property[i].number;
+    value.boolean = property[i].boolean != 0;
+    value.text.assign(text, property[i].textLength);
+    text += property[i].textLength;
+  }
+
+  munmap(map, info.st_size);
+  swap(graph, loaded);
+}
@@ -0,0 +1,76 @@
+//*****************************************************************************
+// Edge language saved sessions
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <stdint.h>
+#include <string>
+
+#include "graph.h"
+
+// First bytes of a session file, and the layout version after them
+#define SESSION_MAGIC   "EDGESESS"
+#define SESSION_VERSION 2
+
+// Sections of a session file, in file order
+enum SessionSection {
+  SECTION_VERTICES,       // Vertex records
+  SECTION_EDGES,          // Edge records
+  SECTION_TEXT,           // Graph::text
+  SECTION_NAMES,          // slots of each TextIndex
+  SECTION_LABELS,
+  SECTION_STRINGS,
+  SECTION_PROPERTIES,     // a SessionProperty for each property
+  SECTION_PROPERTY_TEXT,  // the text of string properties, one after another
+  SECTION_STRUCTURES,     // a SessionStructure for each generated structure
+  SECTION_COUNT
+};
+
+// Where each section is, as offsets from the start of the file, so the
+// file means the same wherever it is mapped
+struct SessionHeader {
+  char     magic[8];
+  uint32_t version;
+  uint32_t propertyCount;
+  int32_t  current;                  // vertex bound to _, or -1
+  int32_t  directedEdges;
+  uint64_t namesUsed;                // used slots of each TextIndex
+  uint64_t labelsUsed;
+  uint64_t stringsUsed;
+  uint64_t offset[SECTION_COUNT];    // 8 byte aligned
+  uint64_t length[SECTION_COUNT];    // in bytes
+  uint64_t size;                     // of the whole file
+};
+
+// A property value as saved
+struct SessionProperty {
+  double   number;
+  uint32_t boolean;
+  uint32_t textLength;
+};
+
+// A generated structure as saved
+struct SessionStructure {
+  uint32_t kind;
+  uint32_t firstVertex;
+  uint32_t vertices;
+  uint32_t width;
+  uint32_t firstEdge;
+  uint32_t edges;
+  uint32_t directed;
+  uint32_t unused;
+};
+
+// Write a graph to a session file. Errors are thrown as messages.
+void saveSession ( const Graph &, const std::string & );
+
+// Replace a graph with the one in a session file. The file is mapped and
+// each section copied whole, hash tables included, so nothing is parsed or
+// hashed again. Errors are thrown as messages and leave the graph as it
+// was.
+void loadSession ( Graph &, const std::string & );
+
+#endif
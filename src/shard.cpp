@@ -0,0 +1,338 @@
+//*****************************************************************************
+// Edge language output sharded by connected component
+// written by Josh Hawkins
+//*****************************************************************************
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "shard.h"
+#include "emit.h"
+
+using namespace std;
+
+// Message thrown when a shard can not be written
+static char shardError[512];
+
+//*****************************************************************************
+// Lock-free union-find
+//
+// Every parent is at most its child, so a root is the smallest position in
+// its set and the components come out the same whatever the threads do.
+// Halving a path only ever moves a parent closer to the root, which other
+// threads may see early or late without harm.
+//*****************************************************************************
+static uint32_t findRoot(atomic<uint32_t> *parent, uint32_t v)
+{
+  for (;;) {
+    uint32_t p = parent[v].load(memory_order_relaxed);
+    if (p == v)
+      return v;
+
+    uint32_t grandparent = parent[p].load(memory_order_relaxed);
+    if (grandparent != p)
+      parent[v].compare_exchange_weak(p, grandparent, memory_order_relaxed);
+    v = grandparent;
+  }
+}
+//*****************************************************************************
+static void unite(atomic<uint32_t> *parent, uint32_t a, uint32_t b)
+{
+  for (;;) {
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a == b)
+      return;
+
+    // Link the larger root under the smaller; if a was linked meanwhile,
+    // start again from where it went
+    if (a < b)
+      swap(a, b);
+    uint32_t expected = a;
+    if (parent[a].compare_exchange_strong(expected, b, memory_order_relaxed))
+      return;
+  }
+}
+//*****************************************************************************
+static void uniteEdges(atomic<uint32_t> *parent, const Graph *graph,
+                       size_t first, size_t last)
+{
+  for (size_t i = first; i < last; i++)
+    unite(parent, graph->edges[i].source, graph->edges[i].target);
+}
+//*****************************************************************************
+vector<uint32_t> findComponents(const Graph &graph)
+{
+  size_t count = graph.vertices.size();
+  vector< atomic<uint32_t> > parent(count);
+  for (size_t v = 0; v < count; v++)
+    parent[v].store(v, memory_order_relaxed);
+
+  size_t threads = thread::hardware_concurrency();
+  size_t most = graph.edges.size() / SHARD_EDGES_PER_THREAD;
+  if (threads > most)
+    threads = most;
+
+  if (threads <= 1)
+    uniteEdges(parent.data(), &graph, 0, graph.edges.size());
+  else {
+    vector<thread> workers;
+    size_t chunk = (graph.edges.size() + threads - 1) / threads;
+    for (size_t t = 0; t < threads; t++) {
+      size_t first = t * chunk;
+      size_t last = min(first + chunk, graph.edges.size());
+      workers.push_back(thread(uniteEdges, parent.data(), &graph, first, last));
+    }
+    for (size_t t = 0; t < threads; t++)
+      workers[t].join();
+  }
+
+  // Roots come before their children, so one pass finds every root
+  vector<uint32_t> component(count);
+  for (size_t v = 0; v < count; v++) {
+    uint32_t p = parent[v].load(memory_order_relaxed);
+    component[v] = p == v ? v : component[p];
+  }
+  return component;
+}
+
+//*****************************************************************************
+// Shard planning
+//*****************************************************************************
+
+// Size of a component and the shard it goes into
+struct ComponentSize {
+  uint32_t root;
+  size_t   records;     // vertices plus edges
+  size_t   shard;
+};
+
+struct LargerComponent {
+  bool operator() (const ComponentSize &a, const ComponentSize &b) const
+  {
+    if (a.records != b.records)
+      return a.records > b.records;
+    return a.root < b.root;
+  }
+};
+
+//*****************************************************************************
+// Shard files take the format as their extension, like batch outputs
+static string shardName(const string &manifest, size_t n, const string &format)
+{
+  string extension = "." + format;
+  size_t slash = manifest.rfind('/');
+  string base = slash == string::npos ? manifest : manifest.substr(slash + 1);
+  if (base.size() > extension.size() &&
+      base.compare(base.size() - extension.size(), extension.size(),
+                   extension) == 0)
+    base.resize(base.size() - extension.size());
+  return base + "." + to_string(n) + extension;
+}
+//*****************************************************************************
+vector<Shard> planShards(const Graph &graph, const string &manifest,
+                         const string &format)
+{
+  vector<uint32_t> component = findComponents(graph);
+
+  // Size each component, indexed by its root
+  vector<size_t> records(graph.vertices.size(), 0);
+  for (size_t v = 0; v < component.size(); v++)
+    records[component[v]]++;
+  for (size_t i = 0; i < graph.edges.size(); i++)
+    records[component[graph.edges[i].source]]++;
+
+  vector<ComponentSize> sizes;
+  for (size_t v = 0; v < component.size(); v++) {
+    if (component[v] == v) {
+      ComponentSize size = { (uint32_t) v, records[v], 0 };
+      sizes.push_back(size);
+    }
+  }
+  sort(sizes.begin(), sizes.end(), LargerComponent());
+
+  // Large components get a shard each; small ones fill shards in turn
+  vector<Shard> shards;
+  size_t filled = SHARD_MIN_RECORDS;
+  for (size_t i = 0; i < sizes.size(); i++) {
+    if (filled >= SHARD_MIN_RECORDS) {
+      shards.push_back(Shard());
+      shards.back().file = shardName(manifest, shards.size() - 1, format);
+      shards.back().components = 0;
+      filled = 0;
+    }
+    sizes[i].shard = shards.size() - 1;
+    shards.back().components++;
+    filled += sizes[i].records;
+  }
+
+  // Reuse records to map each root to its shard
+  for (size_t i = 0; i < sizes.size(); i++)
+    records[sizes[i].root] = sizes[i].shard;
+
+  for (size_t v = 0; v < component.size(); v++)
+    shards[records[component[v]]].vertices.push_back(v);
+  for (size_t i = 0; i < graph.edges.size(); i++)
+    shards[records[component[graph.edges[i].source]]].edges.push_back(i);
+
+  return shards;
+}
+
+//*****************************************************************************
+// Shard and manifest output
+//*****************************************************************************
+static void appendQuoted(string &buffer, const char *text, char quote)
+{
+  buffer += quote;
+  for (; *text; text++) {
+    if (*text == quote || *text == '\\')
+      buffer += '\\';
+    buffer += *text;
+  }
+  buffer += quote;
+}
+//*****************************************************************************
+// Copy the vertices and edges of a shard into a graph of their own, local
+// holding the new position of each vertex. Edges never leave a component,
+// and a structure never leaves its component either, so each keeps its
+// runs of positions and can still be written as loops.
+static void shardGraph(const Graph &graph, const Shard &shard,
+                       vector<uint32_t> &local, Graph &part)
+{
+  part.properties = graph.properties;
+  part.vertices.reserve(shard.vertices.size());
+  part.edges.reserve(shard.edges.size());
+
+  string label;
+  for (size_t i = 0; i < shard.vertices.size(); i++) {
+    uint32_t v = shard.vertices[i];
+    const char *name = vertexName(graph, v);
+    label = vertexLabel(graph, v);
+    local[v] = addVertex(part, name, strlen(name), label);
+  }
+  for (size_t i = 0; i < shard.edges.size(); i++) {
+    const Edge &e = graph.edges[shard.edges[i]];
+    addEdge(part, local[e.source], local[e.target], e.directed);
+  }
+
+  // Edges of a shard are in source order, so the first of a structure's
+  // edges is found by a binary search
+  for (size_t k = 0; k < graph.structures.size(); k++) {
+    Structure s = graph.structures[k];
+    if (s.vertices == 0 || s.edges == 0 ||
+        s.firstVertex >= local.size() ||
+        local[s.firstVertex] >= shard.vertices.size() ||
+        shard.vertices[local[s.firstVertex]] != s.firstVertex)
+      continue;
+    vector<uint32_t>::const_iterator first =
+      lower_bound(shard.edges.begin(), shard.edges.end(), s.firstEdge);
+    if (first == shard.edges.end() || *first != s.firstEdge)
+      continue;
+    s.firstVertex = local[s.firstVertex];
+    s.firstEdge = first - shard.edges.begin();
+    part.structures.push_back(s);
+  }
+}
+//*****************************************************************************
+static void writeShard(const Graph &graph, const Shard &shard,
+                       vector<uint32_t> &local, Emitter &emitter,
+                       const string &path)
+{
+  Graph part;
+  shardGraph(graph, shard, local, part);
+
+  OutputFile out;
+  if (!out.open(path)) {
+    snprintf(shardError, sizeof(shardError), "can not write shard %s",
+             path.c_str());
+    throw (char const *) shardError;
+  }
+  emitter.emit(part, out);
+  out.close();
+}
+//*****************************************************************************
+// The js manifest creates the graph, then loads the shards one after
+// another, largest first, so the biggest components render while the rest
+// load. Each shard adds its vertices and edges to that graph.
+static void jsManifest(const vector<Shard> &shards, string &buffer)
+{
+  buffer += "/* Generated by Edge v.0.0.1 */\n"
+            "(function() {"
+            "\n  var graph = new Graph2D(document.getElementById('edgecanvas'));"
+            "\n  graph.setOption('applyGravity', false);"
+            "\n  window.edgeGraph = graph;"
+            "\n\n  /* Shards, largest first: file, components, vertices, edges */"
+            "\n  var shards = [";
+
+  for (size_t i = 0; i < shards.size(); i++) {
+    buffer += i ? ",\n    [" : "\n    [";
+    appendQuoted(buffer, shards[i].file.c_str(), '\'');
+    buffer += ", " + to_string(shards[i].components);
+    buffer += ", " + to_string(shards[i].vertices.size());
+    buffer += ", " + to_string(shards[i].edges.size());
+    buffer += ']';
+  }
+
+  buffer += "\n  ];"
+            "\n\n  var next = 0;"
+            "\n  function load() {"
+            "\n    if (next == shards.length)"
+            "\n      return;"
+            "\n    var script = document.createElement('script');"
+            "\n    script.src = shards[next++][0];"
+            "\n    script.onload = load;"
+            "\n    document.body.appendChild(script);"
+            "\n  }"
+            "\n  load();"
+            "\n})();";
+}
+//*****************************************************************************
+// Other formats have nothing to load the shards with, so their manifest
+// just lists them in JSON; each shard is a whole document
+static void jsonManifest(const vector<Shard> &shards, string &buffer)
+{
+  buffer += "{\n  \"generator\": \"Edge v.0.0.1\",\n  \"shards\": [";
+  for (size_t i = 0; i < shards.size(); i++) {
+    buffer += i ? ",\n    {\"file\": " : "\n    {\"file\": ";
+    appendQuoted(buffer, shards[i].file.c_str(), '"');
+    buffer += ", \"components\": " + to_string(shards[i].components);
+    buffer += ", \"vertices\": " + to_string(shards[i].vertices.size());
+    buffer += ", \"edges\": " + to_string(shards[i].edges.size());
+    buffer += '}';
+  }
+  if (!shards.empty())
+    buffer += "\n  ";
+  buffer += "]\n}\n";
+}
+//*****************************************************************************
+void writeShards(const Graph &graph, const string &manifest,
+                 const string &format, OutputFile &out)
+{
+  Emitter *emitter = makeEmitter(format);
+  if (emitter == NULL)
+    throw "unknown output format for shards";
+  emitter->setPart(true);
+
+  vector<Shard> shards = planShards(graph, manifest, format);
+  vector<uint32_t> local(graph.vertices.size());
+
+  size_t slash = manifest.rfind('/');
+  string directory = slash == string::npos ? "" : manifest.substr(0, slash + 1);
+  try {
+    for (size_t i = 0; i < shards.size(); i++)
+      writeShard(graph, shards[i], local, *emitter, directory + shards[i].file);
+  } catch (char const *) {
+    delete emitter;
+    throw;
+  }
+  delete emitter;
+
+  string buffer;
+  if (format == "js")
+    jsManifest(shards, buffer);
+  else
+    jsonManifest(shards, buffer);
+  out.write(buffer);
+}
@@ -0,0 +1,46 @@
+//*****************************************************************************
+// Edge language output sharded by connected component
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "graph.h"
+#include "output.h"
+
+// Fewest vertices and edges a shard holds; smaller components are grouped
+// together until they reach it
+#define SHARD_MIN_RECORDS 4096
+
+// Fewest edges worth splitting between threads when finding components
+#define SHARD_EDGES_PER_THREAD (1 << 16)
+
+// A shard file, holding one or more whole components
+struct Shard {
+  std::string           file;         // name, relative to the manifest
+  std::vector<uint32_t> vertices;     // positions, in source order
+  std::vector<uint32_t> edges;
+  size_t                components;
+};
+
+// Find the connected components, returning for each vertex the smallest
+// position in its component. Edges are united on several threads.
+std::vector<uint32_t> findComponents ( const Graph & );
+
+// Group the components into shards, largest first, naming the shard files
+// after the manifest with the format as their extension
+std::vector<Shard> planShards ( const Graph &, const std::string &,
+                                const std::string & );
+
+// Write the shard files in the given format next to the manifest at the
+// given path, and the manifest listing them to out: for js, a script that
+// loads them. Throws a message if a shard can not be written.
+void writeShards ( const Graph &, const std::string &, const std::string &,
+                   OutputFile & );
+
+#endif
@@ -0,0 +1,59 @@
+//*****************************************************************************
+// Edge language single-producer, single-consumer queue
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef SPSC_H
+#define SPSC_H
+
+#include <stddef.h>
+#include <atomic>
+
+// Bytes kept between the producer's and the consumer's counters, so they
+// do not share a cache line
+#define SPSC_LINE_SIZE 64
+
+//*****************************************************************************
+// Bounded lock-free ring passing values from exactly one producer thread to
+// exactly one consumer thread. Neither side ever waits; a full or empty
+// queue is reported and the caller decides how to back off. N must be a
+// power of two.
+//*****************************************************************************
+template <typename T, size_t N>
+class SpscQueue
+{
+public:
+  SpscQueue () : head(0), tail(0)
+  {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "queue size must be a power of two");
+  }
+
+  // Producer only: add a value, or return false if the queue is full
+  bool push(const T &value)
+  {
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) == N)
+      return false;
+    slots[t & (N - 1)] = value;
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only: take the oldest value, or return false if there is none
+  bool pop(T &value)
+  {
+    size_t h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire))
+      return false;
+    value = slots[h & (N - 1)];
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  alignas(SPSC_LINE_SIZE) std::atomic<size_t> head;   // values taken
+  alignas(SPSC_LINE_SIZE) std::atomic<size_t> tail;   // values added
+  alignas(SPSC_LINE_SIZE) T slots[N];
+};
+
+#endif
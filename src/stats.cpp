@@ -0,0 +1,210 @@
+//*****************************************************************************
+// Edge language graph statistics
+// written by Josh Hawkins
+//*****************************************************************************
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "stats.h"
+#include "shard.h"
+
+using namespace std;
+
+// What one thread finds in its share of the vertices
+struct VertexTally {
+  size_t         isolated;
+  size_t         maxIn;
+  size_t         maxOut;
+  vector<size_t> degreeCounts;
+  map<size_t, size_t> highDegreeCounts;
+
+  VertexTally () : isolated(0), maxIn(0), maxOut(0) {}
+};
+
+//*****************************************************************************
+// Threads to use for a number of records
+static size_t threadCount(size_t records)
+{
+  size_t threads = thread::hardware_concurrency();
+  size_t most = records / STATS_RECORDS_PER_THREAD;
+  if (threads > most)
+    threads = most;
+  return threads ? threads : 1;
+}
+//*****************************************************************************
+static void countDegrees(const Graph *graph, size_t first, size_t last,
+                         atomic<uint32_t> *in, atomic<uint32_t> *out,
+                         size_t *loops)
+{
+  size_t selfLoops = 0;
+  for (size_t i = first; i < last; i++) {
+    const Edge &e = graph->edges[i];
+    out[e.source].fetch_add(1, memory_order_relaxed);
+    in[e.target].fetch_add(1, memory_order_relaxed);
+    selfLoops += e.source == e.target;
+  }
+  *loops = selfLoops;
+}
+//*****************************************************************************
+static void tallyVertices(size_t first, size_t last,
+                          const atomic<uint32_t> *in,
+                          const atomic<uint32_t> *out, VertexTally *tally)
+{
+  for (size_t v = first; v < last; v++) {
+    size_t inDegree = in[v].load(memory_order_relaxed);
+    size_t outDegree = out[v].load(memory_order_relaxed);
+    size_t degree = inDegree + outDegree;
+
+    if (degree >= STATS_DENSE_DEGREES)
+      tally->highDegreeCounts[degree]++;
+    else {
+      if (degree >= tally->degreeCounts.size())
+        tally->degreeCounts.resize(degree + 1, 0);
+      tally->degreeCounts[degree]++;
+    }
+
+    tally->isolated += degree == 0;
+    if (inDegree > tally->maxIn)
+      tally->maxIn = inDegree;
+    if (outDegree > tally->maxOut)
+      tally->maxOut = outDegree;
+  }
+}
+//*****************************************************************************
+// Degrees are counted with one pass over the edges, shared between threads.
+// Each thread then builds its own degree histogram over a range of vertices,
+// and the histograms are added up at the end.
+GraphStats graphStats(const Graph &graph)
+{
+  GraphStats stats;
+  size_t count = graph.vertices.size();
+
+  stats.vertices = count;
+  stats.edges = graph.edges.size();
+  stats.directedEdges = graph.directedEdges;
+
+  vector< atomic<uint32_t> > in(count), out(count);
+  for (size_t v = 0; v < count; v++) {
+    in[v].store(0, memory_order_relaxed);
+    out[v].store(0, memory_order_relaxed);
+  }
+
+  size_t threads = threadCount(stats.edges);
+  vector<size_t> loops(threads, 0);
+  vector<thread> workers;
+  size_t chunk = (stats.edges + threads - 1) / threads;
+  for (size_t t = 0; t < threads; t++) {
+    size_t first = min(t * chunk, stats.edges);
+    size_t last = min(first + chunk, stats.edges);
+    workers.push_back(thread(countDegrees, &graph, first, last, in.data(),
+                             out.data(), &loops[t]));
+  }
+  for (size_t t = 0; t < threads; t++)
+    workers[t].join();
+
+  stats.selfLoops = 0;
+  for (size_t t = 0; t < threads; t++)
+    stats.selfLoops += loops[t];
+
+  threads = threadCount(count);
+  vector<VertexTally> tallies(threads);
+  workers.clear();
+  chunk = (count + threads - 1) / threads;
+  for (size_t t = 0; t < threads; t++) {
+    size_t first = min(t * chunk, count);
+    size_t last = min(first + chunk, count);
+    workers.push_back(thread(tallyVertices, first, last, in.data(),
+                             out.data(), &tallies[t]));
+  }
+  for (size_t t = 0; t < threads; t++)
+    workers[t].join();
+
+  stats.isolatedVertices = stats.maxInDegree = stats.maxOutDegree = 0;
+  for (size_t t = 0; t < threads; t++) {
+    const VertexTally &tally = tallies[t];
+    stats.isolatedVertices += tally.isolated;
+    stats.maxInDegree = max(stats.maxInDegree, tally.maxIn);
+    stats.maxOutDegree = max(stats.maxOutDegree, tally.maxOut);
+
+    if (tally.degreeCounts.size() > stats.degreeCounts.size())
+      stats.degreeCounts.resize(tally.degreeCounts.size(), 0);
+    for (size_t d = 0; d < tally.degreeCounts.size(); d++)
+      stats.degreeCounts[d] += tally.degreeCounts[d];
+    for (const auto &high : tally.highDegreeCounts)
+      stats.highDegreeCounts[high.first] += high.second;
+  }
+  if (!stats.highDegreeCounts.empty())
+    stats.maxDegree = stats.highDegreeCounts.rbegin()->first;
+  else
+    stats.maxDegree = stats.degreeCounts.empty() ? 0
+                                                 : stats.degreeCounts.size() - 1;
+
+  // A directed edge may be one of n(n - 1), an undirected one of half that
+  double pairs = (double) count * (count - 1);
+  size_t undirected = stats.edges - stats.directedEdges;
+  stats.density = pairs > 0 ? (stats.directedEdges + 2.0 * undirected) / pairs
+                            : 0;
+
+  // Component roots are the smallest position in their component
+  vector<uint32_t> component = findComponents(graph);
+  vector<uint32_t> sizes(count, 0);
+  stats.components = stats.largestComponent = 0;
+  for (size_t v = 0; v < count; v++) {
+    stats.components += component[v] == v;
+    size_t size = ++sizes[component[v]];
+    if (size > stats.largestComponent)
+      stats.largestComponent = size;
+  }
+
+  return stats;
+}
+//*****************************************************************************
+static void writeDegree(string &buffer, bool first, size_t degree,
+                        size_t vertices)
+{
+  buffer += first ? "\n    {\"degree\": " : ",\n    {\"degree\": ";
+  buffer += to_string(degree);
+  buffer += ", \"vertices\": ";
+  buffer += to_string(vertices);
+  buffer += '}';
+}
+//*****************************************************************************
+void writeStats(const GraphStats &stats, OutputFile &out)
+{
+  char density[32];
+  snprintf(density, sizeof(density), "%.6g", stats.density);
+
+  string buffer;
+  buffer += "{\n  \"generator\": \"Edge v.0.0.1\",";
+  buffer += "\n  \"vertices\": " + to_string(stats.vertices) + ',';
+  buffer += "\n  \"edges\": " + to_string(stats.edges) + ',';
+  buffer += "\n  \"directedEdges\": " + to_string(stats.directedEdges) + ',';
+  buffer += "\n  \"selfLoops\": " + to_string(stats.selfLoops) + ',';
+  buffer += "\n  \"density\": " + string(density) + ',';
+  buffer += "\n  \"components\": " + to_string(stats.components) + ',';
+  buffer += "\n  \"largestComponent\": " + to_string(stats.largestComponent) + ',';
+  buffer += "\n  \"isolatedVertices\": " + to_string(stats.isolatedVertices) + ',';
+  buffer += "\n  \"maxInDegree\": " + to_string(stats.maxInDegree) + ',';
+  buffer += "\n  \"maxOutDegree\": " + to_string(stats.maxOutDegree) + ',';
+  buffer += "\n  \"maxDegree\": " + to_string(stats.maxDegree) + ',';
+
+  // Only degrees some vertex has are listed
+  buffer += "\n  \"degrees\": [";
+  bool first = true;
+  for (size_t d = 0; d < stats.degreeCounts.size(); d++) {
+    if (stats.degreeCounts[d] != 0) {
+      writeDegree(buffer, first, d, stats.degreeCounts[d]);
+      first = false;
+    }
+  }
+  for (const auto &high : stats.highDegreeCounts) {
+    writeDegree(buffer, first, high.first, high.second);
+    first = false;
+  }
+  buffer += first ? "]\n}\n" : "\n  ]\n}\n";
+
+  out.write(buffer);
+}
@@ -0,0 +1,50 @@
+//*****************************************************************************
+// Edge language graph statistics
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+#include "graph.h"
+#include "output.h"
+
+// Fewest edges or vertices worth handing to another thread
+#define STATS_RECORDS_PER_THREAD (1 << 16)
+
+// Degrees below this are counted in an array, higher ones in a map, so one
+// vertex with a huge degree does not size the histogram
+#define STATS_DENSE_DEGREES 4096
+
+// Summary of a graph's shape. Edges count from their source to their target
+// as written, whether directed or not; a self-loop adds two to the degree
+// of its vertex.
+struct GraphStats {
+  size_t vertices;
+  size_t edges;
+  size_t directedEdges;
+  size_t selfLoops;
+  double density;             // edges over the most the vertices can have
+  size_t components;
+  size_t largestComponent;    // vertices in the largest component
+  size_t isolatedVertices;    // vertices without edges
+  size_t maxInDegree;
+  size_t maxOutDegree;
+  size_t maxDegree;
+  std::vector<size_t> degreeCounts;   // vertices with each low degree
+  std::map<size_t, size_t> highDegreeCounts;   // and with each higher one
+};
+
+// Compute the statistics, splitting the edges and then the vertices
+// between threads
+GraphStats graphStats ( const Graph & );
+
+// Write the statistics as JSON
+void writeStats ( const GraphStats &, OutputFile & );
+
+#endif
@@ -0,0 +1,143 @@
+#!/bin/sh
+###############################################################################
+# Edge language regression checks
+# written by Josh Hawkins
+#
+# Each cases/NAME.edge is converted and what edge prints, output and errors
+# alike, is compared with cases/NAME.out. A first line of the form
+# "| flags: ..." gives the case its own command line flags. Modules the
+# cases include live in cases/modules.
+###############################################################################
+cd "$(dirname "$0")/cases" || exit 1
+EDGE=../../edge
+failed=0
+
+# Vertex names for generated programs: A, B, ..., Z, BA, BB, ...
+NAMES='function name(i,  s) {
+  s = ""
+  do { s = sprintf("%c", 65 + i % 26) s; i = int(i / 26) } while (i > 0)
+  return s
+}'
+
+for program in *.edge; do
+  name=${program%.edge}
+  flags=$(sed -n '1s/^| flags: //p' "$program")
+  $EDGE $flags -i "$program" -o - > "/tmp/edge-check-$name.out" 2>&1
+  if cmp -s "/tmp/edge-check-$name.out" "$name.out"; then
+    rm -f "/tmp/edge-check-$name.out"
+  else
+    echo "FAILED: $name, see /tmp/edge-check-$name.out"
+    failed=1
+  fi
+done
+
+# A module included ahead of a body long enough to keep the pipelined lexer
+# busy must parse the same with --pipeline as without it; the module is
+# long too, so a lexer let go early would scan it
+big=/tmp/edge-check-pipeline
+awk -v big=$big "$NAMES"'
+     BEGIN {
+       for (i = 0; i < 20000; i++)
+         print "M" name(i) " -> M" name(i + 1) > (big ".module.edge")
+       print "include \"edge-check-pipeline.module.edge\""
+       for (i = 0; i < 200000; i++)
+         print name(i) " -> " name(i + 1)
+     }' > $big.edge
+if ! $EDGE -i $big.edge -o $big.js > /dev/null 2>&1; then
+  echo "FAILED: include before a long body does not parse, see $big.edge"
+  failed=1
+fi
+for run in 1 2 3 4 5 6; do
+  $EDGE --pipeline -i $big.edge -o $big.pipeline.js > /dev/null 2>&1
+  if ! cmp -s $big.js $big.pipeline.js; then
+    echo "FAILED: include before a long body differs with --pipeline, see $big.*"
+    failed=1
+    break
+  fi
+done
+[ $failed = 0 ] && rm -f $big.edge $big.module.edge $big.js $big.pipeline.js
+
+# Reference graphs must stay within the memory budgets in graph.h, which
+# only apply above BUDGET_MIN_COUNT vertices and edges: a long chain, a
+# graph of many edges per vertex, labeled vertices, and a generated grid
+ref=/tmp/edge-check-budget
+awk "$NAMES"'
+     BEGIN {
+       for (i = 0; i < 100000; i++)
+         print name(i) " -> " name(i + 1) > "'$ref'.chain.edge"
+       for (i = 0; i < 200000; i++)
+         print name(i % 20000) " -> " name((i * 7919) % 20000) > "'$ref'.dense.edge"
+       for (i = 0; i < 50000; i++) {
+         print name(i) " :: l" i > "'$ref'.labels.edge"
+         if (i > 0)
+           print "l" (i - 1) " -> l" i > "'$ref'.labels.edge"
+       }
+       print "grid(300, 300)" > "'$ref'.grid.edge"
+     }'
+for graph in chain dense labels grid; do
+  if ! $EDGE --mem-report -i $ref.$graph.edge -o /dev/null > $ref.$graph.out 2>&1; then
+    echo "FAILED: the $graph reference graph is over its memory budget, see $ref.$graph.*"
+    failed=1
+  else
+    rm -f $ref.$graph.edge $ref.$graph.out
+  fi
+done
+
+# A failed parse, or a check, leaves the last output as it was
+kept=/tmp/edge-check-kept
+echo "A -> B" > $kept.edge
+$EDGE -i $kept.edge -o $kept.js > /dev/null 2>&1
+cp $kept.js $kept.good.js
+echo "A ->" > $kept.bad.edge
+$EDGE -i $kept.bad.edge -o $kept.js > /dev/null 2>&1
+$EDGE --check -i $kept.edge -o $kept.js > /dev/null 2>&1
+if cmp -s $kept.js $kept.good.js; then
+  rm -f $kept.edge $kept.bad.edge $kept.js $kept.good.js
+else
+  echo "FAILED: the output was changed without a graph to write, see $kept.*"
+  failed=1
+fi
+
+# A resumed session writes its generated structures as loops, like the
+# run that saved it
+session=/tmp/edge-check-session
+printf 'ring(5)\nX -> R1\ngrid(3, 2)\n:save "%s"\n' $session.sess > $session.edge
+echo "Z -> X" > $session.rest.edge
+cat $session.edge $session.rest.edge | grep -v :save > $session.all.edge
+$EDGE -i $session.edge -o /dev/null > /dev/null 2>&1
+$EDGE --resume $session.sess -i $session.rest.edge -o $session.js > /dev/null 2>&1
+$EDGE -i $session.all.edge -o $session.all.js > /dev/null 2>&1
+if cmp -s $session.js $session.all.js; then
+  rm -f $session.*
+else
+  echo "FAILED: a resumed session is written differently, see $session.*"
+  failed=1
+fi
+
+# The pipeline and batches write structures as loops, like a plain run
+modes=/tmp/edge-check-modes
+printf 'ring(5)\nX -> R1\ngrid(3, 2)\nchain(4, C)\n' > $modes.edge
+$EDGE -i $modes.edge -o $modes.plain.js > /dev/null 2>&1
+$EDGE --pipeline -i $modes.edge -o $modes.pipeline.js > /dev/null 2>&1
+$EDGE --batch $modes.edge -f js > /dev/null 2>&1
+if cmp -s $modes.plain.js $modes.pipeline.js && cmp -s $modes.plain.js $modes.js; then
+  rm -f $modes.*
+else
+  echo "FAILED: --pipeline or --batch output differs from a plain run, see $modes.*"
+  failed=1
+fi
+
+# Writing the output allocates nothing once its buffers have grown
+if ! $EDGE --alloc-check > /dev/null 2>&1; then
+  echo "FAILED: writing the output allocates, see $EDGE --alloc-check"
+  failed=1
+fi
+
+# A missing input is an error, not an empty program on stdin
+if $EDGE -i /tmp/edge-check-missing.edge -o /dev/null < /dev/null > /dev/null 2>&1; then
+  echo "FAILED: a missing input file was not reported"
+  failed=1
+fi
+
+[ $failed = 0 ] && echo "All regression checks passed"
+exit $failed
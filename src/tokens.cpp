@@ -0,0 +1,98 @@
+//*****************************************************************************
+// Edge language token stream
+// written by Josh Hawkins
+//*****************************************************************************
+#include <string.h>
+
+#include <stdio.h>
+
+#include "lexer.h"
+#include "tokens.h"
+#include "parser.h"
+#include "pipeline.h"
+#include "reader.h"
+
+extern "C"
+{
+extern size_t yyleng;       // length of current lexeme
+extern char  *yytext;       // text of current lexeme
+extern int    yylex();      // the generated lexical analyzer
+extern int    yyLine;       // the current source code line
+extern int    yyInteractive(); // the input is typed in
+}
+
+// Bytes of text kept per ring slot; strings are the longest lexemes
+#define TOKEN_TEXT_SIZE (MAX_STRING_LEN + 1)
+
+// Message thrown for a token too long to keep
+static char tokenError[128];
+
+//*****************************************************************************
+TokenStream::TokenStream() :
+  store(TOKEN_RING_SIZE * TOKEN_TEXT_SIZE), head(0), tail(0), pipe(NULL)
+{
+}
+//*****************************************************************************
+void TokenStream::resumeLexer()
+{
+  if (pipe)
+    pipe->resume();
+}
+//*****************************************************************************
+// Lex into every free slot in one tight loop, stopping after the end of
+// file. Slots holding the last TOKEN_HISTORY consumed tokens are not free.
+// Typed input is only lexed as far as the parser looks, so a statement
+// takes effect as soon as it has been entered.
+void TokenStream::fill(size_t k)
+{
+  uint64_t limit = head + TOKEN_RING_SIZE - TOKEN_HISTORY;
+  if (pipe == NULL && yyInteractive())
+    limit = head + k + 1;
+
+  while (tail < limit) {
+    if (tail > head && ring[(tail - 1) & (TOKEN_RING_SIZE - 1)].kind == TOK_EOF)
+      return;
+
+    size_t slot = tail & (TOKEN_RING_SIZE - 1);
+    Token &token = ring[slot];
+    const char *text;
+    size_t length;
+
+    if (pipe) {
+      // Only wait for the lexer when there is nothing left to parse
+      const Token *piped = pipe->take(text, tail == head);
+      if (piped == NULL)
+        return;
+      token.kind = piped->kind;
+      token.line = piped->line;
+      length = piped->length;
+    } else {
+      token.kind = yylex();
+      token.line = yyLine;
+      text = yytext;
+      length = yyleng;
+    }
+
+    // A file that could not be read to its end fails the run rather than
+    // parsing as if it were shorter
+    if (token.kind == TOK_EOF && readError() != 0) {
+      parseLine = token.line;
+      snprintf(tokenError, sizeof(tokenError), "cannot read the input: %s",
+               strerror(readError()));
+      throw (char const *) tokenError;
+    }
+
+    if (length >= TOKEN_TEXT_SIZE) {
+      parseLine = token.line;
+      snprintf(tokenError, sizeof(tokenError),
+               "name or string is longer than %d characters", MAX_STRING_LEN);
+      throw (char const *) tokenError;
+    }
+
+    token.offset = slot * TOKEN_TEXT_SIZE;
+    token.length = length;
+    memcpy(&store[token.offset], text, token.length);
+    store[token.offset + token.length] = '\0';
+    tail++;
+  }
+}
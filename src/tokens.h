@@ -0,0 +1,98 @@
+//*****************************************************************************
+// Edge language token stream
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef TOKENS_H
+#define TOKENS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "lexer.h"
+
+// Tokens held by a stream, lexed ahead or recently consumed. A power of two.
+#define TOKEN_RING_SIZE 64
+
+// Consumed tokens whose text stays valid, so a production can hold on to
+// the tokens it has just passed
+#define TOKEN_HISTORY   4
+
+// Furthest a parser may look ahead of the current token
+#define TOKEN_LOOKAHEAD (TOKEN_RING_SIZE - TOKEN_HISTORY - 1)
+
+// Tokens lexed on another thread, see pipeline.h
+class TokenPipe;
+
+// A lexed token. Its text is NUL-terminated in the stream that lexed it.
+struct Token {
+  int      kind;      // token code from lexer.h
+  uint32_t offset;    // offset of the text in the stream's text store
+  uint32_t length;    // length of the text
+  int      line;      // source line the token ended on
+};
+
+//*****************************************************************************
+// Token stream
+//
+// Tokens are lexed in batches into a fixed ring, each copied with its text
+// into a slot of the text store, so the parser can look several tokens
+// ahead and keep tokens it has passed without copying yytext. A stream
+// reads from whichever flex buffer is current when it lexes, unless it is
+// given a pipe to take tokens from instead.
+//*****************************************************************************
+class TokenStream
+{
+public:
+  TokenStream ();
+
+  // The token k places ahead of the current one, k <= TOKEN_LOOKAHEAD.
+  // Looking past the end of the input gives the end of file token.
+  const Token &peek(size_t k = 0)
+  {
+    if (tail - head <= k)
+      fill(k);
+    uint64_t i = head + k < tail ? head + k : tail - 1;
+    return ring[i & (TOKEN_RING_SIZE - 1)];
+  }
+
+  // Move past the current token; the end of file token is never passed
+  void next()
+  {
+    if (peek().kind != TOK_EOF)
+      head++;
+  }
+
+  const char *text(const Token &token) const
+  {
+    return &store[token.offset];
+  }
+
+  // Change what kind of token the current one is, for words that are only
+  // keywords where the parser says so
+  void retag(int kind)
+  {
+    ring[head & (TOKEN_RING_SIZE - 1)].kind = kind;
+  }
+
+  // Take tokens from a pipe rather than lexing them
+  void readFrom(TokenPipe *source)
+  {
+    pipe = source;
+  }
+
+  // Let the pipe's lexer go on after an include, if there is a pipe
+  void resumeLexer ( void );
+
+private:
+  void fill ( size_t );
+
+  Token             ring[TOKEN_RING_SIZE];
+  std::vector<char> store;        // text of each ring slot
+  uint64_t          head;         // tokens consumed
+  uint64_t          tail;         // tokens lexed
+  TokenPipe        *pipe;         // where tokens come from, or NULL to lex
+};
+
+#endif
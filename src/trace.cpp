@@ -0,0 +1,119 @@
+//*****************************************************************************
+// Edge language trace events
+// written by Josh Hawkins
+//*****************************************************************************
+#include <stdio.h>
+#include <stdint.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "trace.h"
+
+using namespace std;
+
+int tracing = 0;
+
+// A span starting or ending. Names are string literals, so only their
+// addresses are kept.
+struct TraceEvent {
+  const char *name;
+  const char *category;
+  uint64_t    time;       // nanoseconds since tracing began
+  char        phase;      // 'B' or 'E'
+};
+
+// The events of one thread, in blocks so recording never copies them
+struct TraceLog {
+  vector< vector<TraceEvent> > blocks;
+  string                       name;
+  int                          id;
+};
+
+// Every thread's log, kept until the process ends, as threads may end
+// before the trace is written
+static mutex logsLock;
+static vector<TraceLog *> logs;
+static thread_local TraceLog *threadLog = NULL;
+static const chrono::steady_clock::time_point began = chrono::steady_clock::now();
+
+//*****************************************************************************
+// The calling thread's log; only its first event takes the lock
+static TraceLog *traceLog()
+{
+  if (threadLog == NULL) {
+    threadLog = new TraceLog();
+    lock_guard<mutex> hold(logsLock);
+    threadLog->id = logs.size();
+    logs.push_back(threadLog);
+  }
+  return threadLog;
+}
+//*****************************************************************************
+static void record(const char *name, const char *category, char phase)
+{
+  uint64_t time = chrono::duration_cast<chrono::nanoseconds>(
+                    chrono::steady_clock::now() - began).count();
+  TraceLog *log = traceLog();
+
+  if (log->blocks.empty() || log->blocks.back().size() == TRACE_BLOCK_EVENTS) {
+    log->blocks.push_back(vector<TraceEvent>());
+    log->blocks.back().reserve(TRACE_BLOCK_EVENTS);
+  }
+
+  TraceEvent event = { name, category, time, phase };
+  log->blocks.back().push_back(event);
+}
+//*****************************************************************************
+void traceBegin(const char *name, const char *category)
+{
+  record(name, category, 'B');
+}
+//*****************************************************************************
+void traceEnd(const char *name, const char *category)
+{
+  record(name, category, 'E');
+}
+//*****************************************************************************
+void traceThread(const char *name)
+{
+  traceLog()->name = name;
+}
+//*****************************************************************************
+// Event names are literals from this program, none of which need escaping
+int writeTrace(const char *path)
+{
+  FILE *file = fopen(path, "w");
+  if (file == NULL)
+    return 0;
+
+  lock_guard<mutex> hold(logsLock);
+  const char *separator = "\n";
+
+  fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+  for (size_t t = 0; t < logs.size(); t++) {
+    const TraceLog &log = *logs[t];
+    if (!log.name.empty()) {
+      fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+              "\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+              separator, log.id, log.name.c_str());
+      separator = ",\n";
+    }
+
+    for (size_t b = 0; b < log.blocks.size(); b++) {
+      for (size_t i = 0; i < log.blocks[b].size(); i++) {
+        const TraceEvent &event = log.blocks[b][i];
+        fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\","
+                "\"ts\":%llu.%03u,\"pid\":1,\"tid\":%d}",
+                separator, event.name, event.category, event.phase,
+                (unsigned long long) (event.time / 1000),
+                (unsigned) (event.time % 1000), log.id);
+        separator = ",\n";
+      }
+    }
+  }
+  fprintf(file, "\n]}\n");
+
+  return fclose(file) == 0;
+}
@@ -0,0 +1,37 @@
+//*****************************************************************************
+// Edge language trace events
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef TRACE_H
+#define TRACE_H
+
+// Events a thread's buffer makes room for at a time
+#define TRACE_BLOCK_EVENTS (1 << 16)
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Whether events are being recorded. Callers test it before recording, so
+// tracing costs a branch when it is off.
+extern int tracing;
+
+// Record the start and end of a span of work on the calling thread. Each
+// thread records into a buffer of its own, so no lock is taken.
+void traceBegin ( const char *, const char * );
+void traceEnd ( const char *, const char * );
+
+// Name the calling thread in the trace
+void traceThread ( const char * );
+
+// Write every event recorded so far as Chrome trace event JSON, returning
+// 0 if the file could not be written
+int writeTrace ( const char * );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,118 @@
+//*****************************************************************************
+// Edge language parse tree
+// written by Josh Hawkins
+//*****************************************************************************
+#include <stdio.h>
+#include <string.h>
+
+#include "tree.h"
+
+using namespace std;
+
+// Kinds as they are named in the JSON
+static const char *kindNames[] = { "nonterminal", "token", "note" };
+
+//*****************************************************************************
+ParseTree::ParseTree()
+{
+}
+//*****************************************************************************
+void ParseTree::enter(const char *name, int line)
+{
+  add(TREE_NONTERMINAL, name, strlen(name), line);
+  nodes.back().last = -1;
+  open.push_back(nodes.size() - 1);
+}
+//*****************************************************************************
+void ParseTree::exit(int line)
+{
+  nodes[open.back()].last = line;
+  open.pop_back();
+}
+//*****************************************************************************
+void ParseTree::add(TreeNodeKind kind, const char *name, size_t length,
+                    int line)
+{
+  // The end of file token's text is a NUL
+  length = strnlen(name, length);
+
+  TreeNode node;
+  node.kind = kind;
+  node.parent = open.empty() ? -1 : open.back();
+  node.first = node.last = line;
+  node.offset = text.size();
+  node.length = length;
+
+  text.append(name, length);
+  nodes.push_back(node);
+}
+//*****************************************************************************
+// Each node is indented one space deeper than its parent. A nonterminal is
+// left once the nodes after it are no longer below it, and only shows as
+// left if the parser got that far.
+void ParseTree::writeText(string &out) const
+{
+  vector<int> depth(nodes.size());
+  vector<int> stack;
+
+  for (size_t i = 0; i <= nodes.size(); i++) {
+    int parent = i < nodes.size() ? nodes[i].parent : -1;
+    while (!stack.empty() && stack.back() != parent) {
+      const TreeNode &left = nodes[stack.back()];
+      if (left.last >= 0) {
+        out.append(depth[stack.back()], ' ');
+        out += "exit ";
+        out.append(text, left.offset, left.length);
+        out += '\n';
+      }
+      stack.pop_back();
+    }
+    if (i == nodes.size())
+      break;
+
+    const TreeNode &node = nodes[i];
+    depth[i] = parent < 0 ? 0 : depth[parent] + 1;
+    out.append(depth[i], ' ');
+    if (node.kind == TREE_NONTERMINAL) {
+      out += "enter ";
+      stack.push_back(i);
+    } else if (node.kind == TREE_TOKEN)
+      out += "-->found ";
+    else
+      out += "-->";
+    out.append(text, node.offset, node.length);
+    out += '\n';
+  }
+}
+//*****************************************************************************
+void ParseTree::writeJson(string &out) const
+{
+  char number[64];
+
+  out += "{\n  \"nodes\": [";
+  for (size_t i = 0; i < nodes.size(); i++) {
+    const TreeNode &node = nodes[i];
+    out += i ? ",\n    " : "\n    ";
+    out += "{\"kind\": \"";
+    out += kindNames[node.kind];
+    out += "\", \"text\": \"";
+
+    for (uint32_t k = node.offset; k < node.offset + node.length; k++) {
+      unsigned char c = text[k];
+      if (c == '"' || c == '\\') {
+        out += '\\';
+        out += c;
+      } else if (c < 0x20) {
+        snprintf(number, sizeof(number), "\\u%04x", c);
+        out += number;
+      } else
+        out += c;
+    }
+
+    snprintf(number, sizeof(number),
+             "\", \"parent\": %d, \"first\": %d, \"last\": %d}",
+             node.parent, node.first, node.last);
+    out += number;
+  }
+  out += "\n  ]\n}\n";
+}
@@ -0,0 +1,63 @@
+//*****************************************************************************
+// Edge language parse tree
+// written by Josh Hawkins
+//*****************************************************************************
+
+#ifndef TREE_H
+#define TREE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// What a parse tree node is
+enum TreeNodeKind {
+  TREE_NONTERMINAL,   // a part of the grammar, holding the nodes below
+  TREE_TOKEN,         // a token matched
+  TREE_NOTE           // something the parser did, such as importing edges
+};
+
+// A node of the parse tree. Nodes are kept in the order they were met, so
+// a node always comes after its parent.
+struct TreeNode {
+  int      kind;      // TreeNodeKind
+  int      parent;    // index of the enclosing nonterminal, or -1
+  int      first;     // first source line
+  int      last;      // last source line, or -1 while a nonterminal is open
+  uint32_t offset;    // offset of the name or text in ParseTree::text
+  uint32_t length;
+};
+
+//*****************************************************************************
+// Parse tree
+//
+// Nodes are recorded as the parser meets them, as a flat list with parent
+// indices, and written out in one piece once parsing is over: as the
+// indented listing -p prints, or as JSON. Included modules are parsed in
+// the middle of the include that names them, so their trees hang below it.
+//*****************************************************************************
+class ParseTree
+{
+public:
+  ParseTree ();
+
+  // Open a nonterminal at a line, below the innermost open one
+  void enter ( const char *, int );
+
+  // Close the innermost open nonterminal at a line
+  void exit ( int );
+
+  // Add a token or note below the innermost open nonterminal
+  void add ( TreeNodeKind, const char *, size_t, int );
+
+  // Append the indented listing, or the JSON, to a string
+  void writeText ( std::string & ) const;
+  void writeJson ( std::string & ) const;
+
+private:
+  std::vector<TreeNode> nodes;
+  std::vector<int>      open;   // nonterminals entered and not yet left
+  std::string           text;
+};
+
+#endif
@@ -0,0 +1,298 @@
+//*****************************************************************************
+// Edge language incremental rebuilds for --watch
+// written by Josh Hawkins
+//*****************************************************************************
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "parser.h"
+
+using namespace std;
+
+// Quiet time after a change before rebuilding, so an editor's burst of
+// writes is handled once
+#define WATCH_DEBOUNCE_MS 20
+
+// What a watched program looked like when it was last parsed
+struct WatchState {
+  string                path;         // canonical path of the input
+  string                text;         // its contents
+  vector<StatementMark> statements;   // graph state before each statement
+  set<string>           dependencies; // canonical paths imported or included
+  int                   resumeLine;   // where to carry on when the
+                                      // statements run out, after an error
+
+  WatchState () : resumeLine(1) {}
+};
+
+//*****************************************************************************
+// Read a whole file, returning false if it can not be read
+static bool readFile(const string &path, string &text)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat info;
+  if (fstat(fd, &info) < 0) {
+    close(fd);
+    return false;
+  }
+
+  text.resize(info.st_size);
+  size_t done = 0;
+  while (done < text.size()) {
+    ssize_t got = read(fd, &text[done], text.size() - done);
+    if (got < 0 && errno == EINTR)
+      continue;
+    if (got <= 0)
+      break;
+    done += got;
+  }
+  text.resize(done);
+  close(fd);
+  return true;
+}
+//*****************************************************************************
+// First line at which two texts differ; lines before it are identical
+static int firstChangedLine(const string &before, const string &after)
+{
+  size_t length = min(before.size(), after.size());
+  size_t same = 0;
+  while (same < length && before[same] == after[same])
+    same++;
+
+  int line = 1;
+  for (const char *p = after.data(), *end = p + same;
+       (p = (const char *) memchr(p, '\n', end - p)) != NULL; p++)
+    line++;
+  return line;
+}
+//*****************************************************************************
+// Byte offset at which a line starts
+static size_t lineOffset(const string &text, int line)
+{
+  size_t offset = 0;
+  while (--line > 0) {
+    const char *p = (const char *) memchr(text.data() + offset, '\n',
+                                          text.size() - offset);
+    if (p == NULL)
+      return text.size();
+    offset = p - text.data() + 1;
+  }
+  return offset;
+}
+//*****************************************************************************
+// Bring the graph up to date with the text, re-parsing from the first
+// statement the change can have touched. The graph is rolled back to its
+// state before that statement, so everything above it is kept as is.
+// Returns the line parsing started on.
+static int reparse(WatchState &state, int changedLine)
+{
+  vector<StatementMark> &statements = state.statements;
+
+  // The statement before the change may run on into it, and a line may
+  // hold several statements, so start at the first one on its line
+  size_t j = lower_bound(statements.begin(), statements.end(), changedLine,
+                         [](const StatementMark &s, int line)
+                         { return s.line < line; }) - statements.begin();
+  if (j > 0)
+    j--;
+  while (j > 0 && statements[j - 1].line == statements[j].line)
+    j--;
+
+  int startLine = state.resumeLine;
+  if (j < statements.size()) {
+    startLine = statements[j].line;
+    rollbackGraph(graph, statements[j].mark);
+    statements.resize(j);
+  }
+  GraphMark before = markGraph(graph);
+
+  size_t offset = lineOffset(state.text, startLine);
+  tokens = TokenStream();
+  yyLine = startLine;
+  yySetCondition(0);
+  parseLine = startLine;
+  statementLog = &statements;
+  dependencyLog = &state.dependencies;
+  YY_BUFFER_STATE buffer = yy_scan_bytes(state.text.data() + offset,
+                                         state.text.size() - offset);
+  try {
+    parseProgram();
+  } catch (char const *errmsg) {
+    yy_delete_buffer(buffer);
+    statementLog = NULL;
+    dependencyLog = NULL;
+
+    // Keep the graph as it was before the statement that failed to parse,
+    // and carry on from there next time
+    rollbackGraph(graph, before);
+    statements.resize(j);
+    state.resumeLine = startLine;
+    throw errmsg;
+  }
+  yy_delete_buffer(buffer);
+  statementLog = NULL;
+  dependencyLog = NULL;
+
+  state.resumeLine = statements.empty() ? 1 : statements.back().line;
+  return startLine;
+}
+//*****************************************************************************
+// Parse everything again, e.g. after an included module changed
+static int rebuild(WatchState &state)
+{
+  forgetModules();
+  state.dependencies.clear();
+  if (!state.statements.empty()) {
+    rollbackGraph(graph, state.statements[0].mark);
+    state.statements.clear();
+  }
+  state.resumeLine = 1;
+  return reparse(state, 1);
+}
+//*****************************************************************************
+// Watch the directory holding a file, so it is seen even when an editor
+// replaces it rather than writing it in place
+static void watchDirectory(int fd, map<int, string> &directories,
+                           const string &path)
+{
+  size_t slash = path.rfind('/');
+  string directory = slash == string::npos ? "." : path.substr(0, slash);
+  if (directory.empty())
+    directory = "/";
+
+  for (map<int, string>::iterator i = directories.begin();
+       i != directories.end(); i++)
+    if (i->second == directory)
+      return;
+
+  int wd = inotify_add_watch(fd, directory.c_str(),
+                             IN_CLOSE_WRITE | IN_MOVED_TO);
+  if (wd >= 0)
+    directories[wd] = directory;
+}
+//*****************************************************************************
+// Read the pending inotify events, noting whether the input or one of its
+// dependencies was written
+static void readEvents(int fd, const map<int, string> &directories,
+                       const WatchState &state, bool &input, bool &dependency)
+{
+  char events[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+  ssize_t length = read(fd, events, sizeof(events));
+  for (char *p = events; length > 0 && p < events + length; ) {
+    struct inotify_event *event = (struct inotify_event *) p;
+    p += sizeof(struct inotify_event) + event->len;
+
+    map<int, string>::const_iterator directory = directories.find(event->wd);
+    if (directory == directories.end() || event->len == 0)
+      continue;
+
+    string path = directory->second + "/" + event->name;
+    if (path == state.path)
+      input = true;
+    else if (state.dependencies.count(path))
+      dependency = true;
+  }
+}
+//*****************************************************************************
+static void writeOutput(const string &outputPath, Emitter *emitter)
+{
+  OutputFile out;
+  if (!out.open(outputPath))
+    throw "cannot write the output file";
+  emitter->emit(graph, out);
+  out.close();
+}
+//*****************************************************************************
+// Parse the input once, then wait for it or anything it imports or includes
+// to change. Changes to the input itself are applied incrementally; a
+// changed dependency rebuilds the whole graph, since its vertices may be
+// used anywhere below the statement that brought it in.
+int watchInput(const string &inputPath, const string &outputPath,
+               Emitter *emitter)
+{
+  WatchState state;
+  state.path = canonicalPath(inputPath);
+  if (!readFile(state.path, state.text)) {
+    cout << "Can not read " << inputPath << endl;
+    return 1;
+  }
+
+  int fd = inotify_init1(IN_CLOEXEC);
+  if (fd < 0) {
+    cout << "Can not watch " << inputPath << ": " << strerror(errno) << endl;
+    return 1;
+  }
+  map<int, string> directories;
+
+  resetParser();
+  graph.journaling = true;
+
+  bool input = false, dependency = true;
+  for (;;) {
+    if (input || dependency) {
+      int changedLine = 1;
+      if (input) {
+        string text;
+        if (!readFile(state.path, text))
+          text.clear();
+        changedLine = firstChangedLine(state.text, text);
+        state.text.swap(text);
+      }
+
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      try {
+        int first = dependency ? rebuild(state) : reparse(state, changedLine);
+        chrono::steady_clock::time_point parsed = chrono::steady_clock::now();
+        writeOutput(outputPath, emitter);
+        chrono::duration<double, milli> parsing = parsed - start;
+        chrono::duration<double, milli> writing =
+          chrono::steady_clock::now() - parsed;
+        cout << "Updated " << outputPath << ": parsed from line " << first
+             << " in " << fixed << setprecision(1) << parsing.count()
+             << " ms, written in " << writing.count() << " ms" << endl;
+      } catch (char const *errmsg) {
+        cout << "***ERROR (line " << parseLine << "): " << errmsg << endl;
+      }
+
+      watchDirectory(fd, directories, state.path);
+      for (set<string>::iterator i = state.dependencies.begin();
+           i != state.dependencies.end(); i++)
+        watchDirectory(fd, directories, *i);
+
+      input = dependency = false;
+    }
+
+    // Wait for a change, then until the writes stop
+    struct pollfd wait = { fd, POLLIN, 0 };
+    if (poll(&wait, 1, -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+    do {
+      readEvents(fd, directories, state, input, dependency);
+    } while (poll(&wait, 1, WATCH_DEBOUNCE_MS) > 0);
+  }
+
+  close(fd);
+  return 1;
+}